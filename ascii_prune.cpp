@@ -0,0 +1,767 @@
+// pruning of blanks from an ascii file -- command-line tool over memory mappings
+#include "ascii_pruner.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <condition_variable>
+#include <mutex>
+#if __linux__
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+// output block when the output is not a regular file, and cannot be mapped
+size_t const block_len = size_t(1) << 24;
+
+void usage(FILE* const f) {
+	fprintf(f,
+		"usage: ascii_prune [-H] [-u] [-j threads] [input [output]]\n"
+		"  -H          hint the kernel to back the buffers with huge pages\n"
+		"  -u          do not use io_uring when streaming\n"
+		"  -j threads  prune on this many threads; 0 for all hardware threads (default)\n"
+		"  input       defaults to stdin; anything but a regular file is streamed\n"
+		"  output      defaults to stdout; a regular file is written through a mapping\n");
+}
+
+// write all of buf[0, len) to fd, retrying on short writes
+bool write_all(
+	int const fd,
+	uint8_t const* buf,
+	size_t len) {
+
+	while (len) {
+		ssize_t const written = write(fd, buf, len);
+
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		buf += written;
+		len -= written;
+	}
+	return true;
+}
+
+// prune src into a regular file through a shared mapping, then cut the file down to the pruned length
+int prune_to_mapping(
+	uint8_t const* const src,
+	size_t const len,
+	int const fd,
+	size_t const threads,
+	bool const huge) {
+
+	if (ftruncate(fd, len)) {
+		fprintf(stderr, "error: cannot size output: %s\n", strerror(errno));
+		return 5;
+	}
+
+	size_t kept = 0;
+
+	if (len) {
+		void* const dst = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+		if (dst == MAP_FAILED) {
+			fprintf(stderr, "error: cannot map output: %s\n", strerror(errno));
+			return 6;
+		}
+
+		madvise(dst, len, MADV_SEQUENTIAL);
+		if (huge)
+			madvise(dst, len, MADV_HUGEPAGE);
+
+		kept = prune_parallel(src, len, static_cast< uint8_t* >(dst), threads);
+		munmap(dst, len);
+	}
+
+	if (ftruncate(fd, kept)) {
+		fprintf(stderr, "error: cannot truncate output: %s\n", strerror(errno));
+		return 5;
+	}
+	return 0;
+}
+
+// prune src block by block into a pair of write buffers, for outputs that cannot be mapped, e.g. pipes: a writer thread
+// writes out block k from the one buffer while block k + 1 is pruned into the other
+int prune_to_buffer(
+	uint8_t const* const src,
+	size_t const len,
+	int const fd,
+	size_t const threads,
+	bool const huge) {
+
+	uint8_t* buf[2];
+	size_t kept[2];
+
+	// huge-page-aligned, so the hint has whole huge pages to work with
+	buf[0] = static_cast< uint8_t* >(aligned_alloc(size_t(1) << 21, block_len));
+	buf[1] = static_cast< uint8_t* >(aligned_alloc(size_t(1) << 21, block_len));
+
+	if (buf[0] == NULL || buf[1] == NULL) {
+		fprintf(stderr, "error: cannot allocate write buffer\n");
+		free(buf[1]);
+		free(buf[0]);
+		return 7;
+	}
+
+	if (huge) {
+		madvise(buf[0], block_len, MADV_HUGEPAGE);
+		madvise(buf[1], block_len, MADV_HUGEPAGE);
+	}
+
+	std::mutex mutex;
+	std::condition_variable cond;
+
+	// blocks pruned and written so far; the writer sets error when it fails
+	size_t pruned_count = 0;
+	size_t written_count = 0;
+	bool pruned_done = false;
+	int error = 0;
+
+	std::thread writer([&]() {
+		for (size_t k = 0; ; ++k) {
+			{
+				std::unique_lock< std::mutex > lock(mutex);
+				cond.wait(lock, [&]() { return k < pruned_count || pruned_done; });
+
+				if (k == pruned_count)
+					break;
+			}
+
+			if (!write_all(fd, buf[k % 2], kept[k % 2])) {
+				std::lock_guard< std::mutex > lock(mutex);
+				fprintf(stderr, "error: cannot write output: %s\n", strerror(errno));
+				error = 8;
+				cond.notify_all();
+				break;
+			}
+
+			std::lock_guard< std::mutex > lock(mutex);
+			written_count = k + 1;
+			cond.notify_all();
+		}
+	});
+
+	for (size_t k = 0, i = 0; i < len; ++k, i += block_len) {
+		{
+			std::unique_lock< std::mutex > lock(mutex);
+			cond.wait(lock, [&]() { return k - written_count < 2 || error; });
+
+			if (error)
+				break;
+		}
+
+		size_t const n = len - i < block_len ? len - i : block_len;
+		kept[k % 2] = prune_parallel(src + i, n, buf[k % 2], threads);
+
+		std::lock_guard< std::mutex > lock(mutex);
+		pruned_count = k + 1;
+		cond.notify_all();
+	}
+
+	{
+		std::lock_guard< std::mutex > lock(mutex);
+		pruned_done = true;
+		cond.notify_all();
+	}
+
+	writer.join();
+	free(buf[1]);
+	free(buf[0]);
+	return error;
+}
+
+// streaming block: a quarter of L2, so the in and out blocks of both the block being pruned and the ones in flight stay
+// in cache
+size_t stream_block_len() {
+	long l2 = 0;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+	l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+
+#endif
+	if (l2 <= 0)
+		l2 = 1 << 20;
+
+	size_t const len = size_t(l2) / 4 & ~size_t(4095);
+	return len < size_t(1) << 16 ? size_t(1) << 16 : len;
+}
+
+// read as much as fd has ready, up to len; retries on EINTR, returns 0 at eof
+ssize_t read_some(
+	int const fd,
+	uint8_t* const buf,
+	size_t const len) {
+
+	ssize_t ret;
+	do
+		ret = read(fd, buf, len);
+	while (ret < 0 && errno == EINTR);
+	return ret;
+}
+
+// stream ring: slot k holds in[k] and its pruned out[k]; the reader, the pruner and the writer walk the slots in order,
+// so while block k is pruned, block k + 1 is read into the other in and block k - 1 is written from the other out
+size_t const stream_depth = 2;
+
+struct stream_ring {
+	uint8_t* in[stream_depth];
+	uint8_t* out[stream_depth];
+	size_t in_len[stream_depth];
+	size_t out_len[stream_depth];
+	size_t block;
+};
+
+bool stream_ring_alloc(
+	stream_ring& ring,
+	bool const huge) {
+
+	ring.block = stream_block_len();
+
+	for (size_t k = 0; k < stream_depth; ++k) {
+		ring.in[k] = static_cast< uint8_t* >(aligned_alloc(4096, ring.block));
+		ring.out[k] = static_cast< uint8_t* >(aligned_alloc(4096, ring.block));
+
+		if (ring.in[k] == NULL || ring.out[k] == NULL)
+			return false;
+
+		if (huge) {
+			madvise(ring.in[k], ring.block, MADV_HUGEPAGE);
+			madvise(ring.out[k], ring.block, MADV_HUGEPAGE);
+		}
+	}
+	return true;
+}
+
+void stream_ring_free(stream_ring& ring) {
+	for (size_t k = 0; k < stream_depth; ++k) {
+		free(ring.in[k]);
+		free(ring.out[k]);
+	}
+}
+
+// fallback pipeline: a reader thread and a writer thread around the pruning thread
+int prune_stream_threads(
+	int const in_fd,
+	int const out_fd,
+	stream_ring& ring) {
+
+	std::mutex mutex;
+	std::condition_variable cond;
+
+	// blocks read, pruned and written so far; a stage that stops sets done, one that fails also sets error
+	size_t read_count = 0;
+	size_t pruned_count = 0;
+	size_t written_count = 0;
+	bool read_done = false;
+	bool pruned_done = false;
+	int error = 0;
+
+	std::thread reader([&]() {
+		for (size_t k = 0; ; ++k) {
+			{
+				std::unique_lock< std::mutex > lock(mutex);
+				cond.wait(lock, [&]() { return k - pruned_count < stream_depth || error; });
+
+				if (error)
+					break;
+			}
+
+			size_t const slot = k % stream_depth;
+			ssize_t const n = read_some(in_fd, ring.in[slot], ring.block);
+
+			if (n <= 0) {
+				std::lock_guard< std::mutex > lock(mutex);
+
+				if (n < 0) {
+					fprintf(stderr, "error: cannot read input: %s\n", strerror(errno));
+					error = 9;
+				}
+				break;
+			}
+
+			ring.in_len[slot] = n;
+
+			std::lock_guard< std::mutex > lock(mutex);
+			read_count = k + 1;
+			cond.notify_all();
+		}
+
+		std::lock_guard< std::mutex > lock(mutex);
+		read_done = true;
+		cond.notify_all();
+	});
+
+	std::thread writer([&]() {
+		for (size_t k = 0; ; ++k) {
+			{
+				std::unique_lock< std::mutex > lock(mutex);
+				cond.wait(lock, [&]() { return k < pruned_count || pruned_done || error; });
+
+				if (k == pruned_count || error)
+					break;
+			}
+
+			size_t const slot = k % stream_depth;
+
+			if (!write_all(out_fd, ring.out[slot], ring.out_len[slot])) {
+				std::lock_guard< std::mutex > lock(mutex);
+				fprintf(stderr, "error: cannot write output: %s\n", strerror(errno));
+				error = 8;
+				break;
+			}
+
+			std::lock_guard< std::mutex > lock(mutex);
+			written_count = k + 1;
+			cond.notify_all();
+		}
+
+		std::lock_guard< std::mutex > lock(mutex);
+		cond.notify_all();
+	});
+
+	for (size_t k = 0; ; ++k) {
+		{
+			std::unique_lock< std::mutex > lock(mutex);
+			cond.wait(lock, [&]() {
+				return (k < read_count && k - written_count < stream_depth) || (read_done && k == read_count) || error; });
+
+			if (k == read_count || error)
+				break;
+		}
+
+		size_t const slot = k % stream_depth;
+		ring.out_len[slot] = prune(ring.in[slot], ring.in_len[slot], ring.out[slot]);
+
+		std::lock_guard< std::mutex > lock(mutex);
+		pruned_count = k + 1;
+		cond.notify_all();
+	}
+
+	{
+		std::lock_guard< std::mutex > lock(mutex);
+		pruned_done = true;
+		cond.notify_all();
+	}
+
+	reader.join();
+	writer.join();
+	return error;
+}
+
+#if __linux__
+// bare io_uring over the raw syscalls, with just what the stream needs: at most one read and one write in flight
+struct uring {
+	int fd;
+	void* sq_ptr;
+	void* cq_ptr;
+	size_t sq_len;
+	size_t cq_len;
+	io_uring_sqe* sqes;
+	size_t sqes_len;
+
+	unsigned* sq_tail;
+	unsigned* sq_mask;
+	unsigned* sq_array;
+	unsigned* cq_head;
+	unsigned* cq_tail;
+	unsigned* cq_mask;
+	io_uring_cqe* cqes;
+};
+
+void uring_exit(uring& r) {
+	if (r.sqes != MAP_FAILED)
+		munmap(r.sqes, r.sqes_len);
+	if (r.cq_ptr != MAP_FAILED && r.cq_ptr != r.sq_ptr)
+		munmap(r.cq_ptr, r.cq_len);
+	if (r.sq_ptr != MAP_FAILED)
+		munmap(r.sq_ptr, r.sq_len);
+	close(r.fd);
+}
+
+// false when the kernel has no io_uring, or one too old to read and write at the current file position
+bool uring_init(
+	uring& r,
+	unsigned const entries) {
+
+	io_uring_params p;
+	memset(&p, 0, sizeof(p));
+
+	r.fd = syscall(__NR_io_uring_setup, entries, &p);
+
+	if (r.fd < 0)
+		return false;
+
+	r.sq_ptr = r.cq_ptr = r.sqes = static_cast< io_uring_sqe* >(MAP_FAILED);
+
+	if (!(p.features & IORING_FEAT_RW_CUR_POS)) {
+		uring_exit(r);
+		return false;
+	}
+
+	r.sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	r.cq_len = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP)
+		r.sq_len = r.cq_len = r.sq_len > r.cq_len ? r.sq_len : r.cq_len;
+
+	r.sq_ptr = mmap(NULL, r.sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.fd, IORING_OFF_SQ_RING);
+	r.cq_ptr = p.features & IORING_FEAT_SINGLE_MMAP ? r.sq_ptr :
+		mmap(NULL, r.cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.fd, IORING_OFF_CQ_RING);
+
+	r.sqes_len = p.sq_entries * sizeof(io_uring_sqe);
+	r.sqes = static_cast< io_uring_sqe* >(
+		mmap(NULL, r.sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.fd, IORING_OFF_SQES));
+
+	if (r.sq_ptr == MAP_FAILED || r.cq_ptr == MAP_FAILED || r.sqes == MAP_FAILED) {
+		uring_exit(r);
+		return false;
+	}
+
+	uint8_t* const sq = static_cast< uint8_t* >(r.sq_ptr);
+	uint8_t* const cq = static_cast< uint8_t* >(r.cq_ptr);
+
+	r.sq_tail = reinterpret_cast< unsigned* >(sq + p.sq_off.tail);
+	r.sq_mask = reinterpret_cast< unsigned* >(sq + p.sq_off.ring_mask);
+	r.sq_array = reinterpret_cast< unsigned* >(sq + p.sq_off.array);
+	r.cq_head = reinterpret_cast< unsigned* >(cq + p.cq_off.head);
+	r.cq_tail = reinterpret_cast< unsigned* >(cq + p.cq_off.tail);
+	r.cq_mask = reinterpret_cast< unsigned* >(cq + p.cq_off.ring_mask);
+	r.cqes = reinterpret_cast< io_uring_cqe* >(cq + p.cq_off.cqes);
+	return true;
+}
+
+// queue a read or write of buf[0, len) at the current file position, and hand it to the kernel
+bool uring_submit(
+	uring& r,
+	uint8_t const op,
+	int const fd,
+	void const* const buf,
+	size_t const len,
+	uint64_t const tag) {
+
+	unsigned const tail = *r.sq_tail;
+	unsigned const idx = tail & *r.sq_mask;
+	io_uring_sqe* const sqe = r.sqes + idx;
+
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = op;
+	sqe->fd = fd;
+	sqe->off = uint64_t(-1);
+	sqe->addr = reinterpret_cast< uint64_t >(buf);
+	sqe->len = len > 1u << 30 ? 1u << 30 : unsigned(len);
+	sqe->user_data = tag;
+
+	r.sq_array[idx] = idx;
+	__atomic_store_n(r.sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	int ret;
+	do
+		ret = syscall(__NR_io_uring_enter, r.fd, 1, 0, 0, NULL, 0);
+	while (ret < 0 && errno == EINTR);
+	return ret == 1;
+}
+
+// block for the next completion
+bool uring_wait(
+	uring& r,
+	io_uring_cqe& cqe) {
+
+	for (;;) {
+		unsigned const head = *r.cq_head;
+
+		if (head != __atomic_load_n(r.cq_tail, __ATOMIC_ACQUIRE)) {
+			cqe = r.cqes[head & *r.cq_mask];
+			__atomic_store_n(r.cq_head, head + 1, __ATOMIC_RELEASE);
+			return true;
+		}
+
+		if (syscall(__NR_io_uring_enter, r.fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR)
+			return false;
+	}
+}
+
+enum { tag_read, tag_write };
+
+// single-threaded pipeline: read of block k + 1 and write of block k - 1 in flight while block k is pruned; writes are
+// issued one at a time, so they land in order even on pipes
+int prune_stream_uring(
+	uring& r,
+	int const in_fd,
+	int const out_fd,
+	stream_ring& ring) {
+
+	// read result of the block in flight, and what is left of the write in flight
+	ssize_t read_res = 0;
+	bool read_busy = false;
+	uint8_t const* write_buf = NULL;
+	size_t write_left = 0;
+
+	// reap completions until the given op is idle, resubmitting short writes
+	auto const reap = [&](bool const for_read) -> int {
+		while (for_read ? read_busy : write_left != 0) {
+			io_uring_cqe cqe;
+
+			if (!uring_wait(r, cqe)) {
+				fprintf(stderr, "error: cannot wait on io_uring: %s\n", strerror(errno));
+				return 10;
+			}
+
+			if (cqe.user_data == tag_read) {
+				read_res = cqe.res;
+				read_busy = false;
+				continue;
+			}
+
+			if (cqe.res < 0 && cqe.res != -EINTR && cqe.res != -EAGAIN) {
+				fprintf(stderr, "error: cannot write output: %s\n", strerror(-cqe.res));
+				return 8;
+			}
+
+			if (cqe.res > 0) {
+				write_buf += cqe.res;
+				write_left -= cqe.res;
+			}
+
+			if (write_left && !uring_submit(r, IORING_OP_WRITE, out_fd, write_buf, write_left, tag_write)) {
+				fprintf(stderr, "error: cannot submit to io_uring: %s\n", strerror(errno));
+				return 10;
+			}
+		}
+		return 0;
+	};
+
+	if (!uring_submit(r, IORING_OP_READ, in_fd, ring.in[0], ring.block, tag_read)) {
+		fprintf(stderr, "error: cannot submit to io_uring: %s\n", strerror(errno));
+		return 10;
+	}
+	read_busy = true;
+
+	int ret = 0;
+
+	for (size_t k = 0; ; ++k) {
+		size_t const slot = k % stream_depth;
+		size_t const next = (k + 1) % stream_depth;
+
+		// retry interrupted reads until one completes for good
+		while (read_busy) {
+			if ((ret = reap(true)))
+				break;
+
+			if (read_res == -EINTR || read_res == -EAGAIN) {
+				if (!uring_submit(r, IORING_OP_READ, in_fd, ring.in[slot], ring.block, tag_read)) {
+					fprintf(stderr, "error: cannot submit to io_uring: %s\n", strerror(errno));
+					ret = 10;
+				}
+				read_busy = ret == 0;
+			}
+		}
+
+		if (ret)
+			break;
+
+		if (read_res < 0) {
+			fprintf(stderr, "error: cannot read input: %s\n", strerror(-read_res));
+			ret = 9;
+			break;
+		}
+
+		if (read_res == 0)
+			break;
+
+		// in[next] was pruned last iteration, so it is free to read into
+		size_t const n = read_res;
+
+		if (!uring_submit(r, IORING_OP_READ, in_fd, ring.in[next], ring.block, tag_read)) {
+			fprintf(stderr, "error: cannot submit to io_uring: %s\n", strerror(errno));
+			ret = 10;
+			break;
+		}
+		read_busy = true;
+
+		// out[slot] was last written two blocks ago, and that write is done: there is never more than one in flight
+		size_t const kept = prune(ring.in[slot], n, ring.out[slot]);
+
+		if ((ret = reap(false)))
+			break;
+
+		if (kept) {
+			write_buf = ring.out[slot];
+			write_left = kept;
+
+			if (!uring_submit(r, IORING_OP_WRITE, out_fd, write_buf, write_left, tag_write)) {
+				fprintf(stderr, "error: cannot submit to io_uring: %s\n", strerror(errno));
+				ret = 10;
+				break;
+			}
+		}
+	}
+
+	if (ret == 0)
+		ret = reap(false);
+
+	return ret;
+}
+
+#endif
+// prune a stream that cannot be mapped, e.g. a pipe or a socket, through a ring of cache-sized blocks
+int prune_stream(
+	int const in_fd,
+	int const out_fd,
+	bool const use_uring,
+	bool const huge) {
+
+	stream_ring ring;
+	memset(&ring, 0, sizeof(ring));
+
+	if (!stream_ring_alloc(ring, huge)) {
+		stream_ring_free(ring);
+		fprintf(stderr, "error: cannot allocate stream buffers\n");
+		return 7;
+	}
+
+	int ret;
+
+#if __linux__
+	uring r;
+
+	if (use_uring && uring_init(r, 4)) {
+		ret = prune_stream_uring(r, in_fd, out_fd, ring);
+		uring_exit(r);
+
+		// a failed stream may leave a read in flight into the ring; the process is about to exit anyway
+		if (ret)
+			return ret;
+	}
+	else
+		ret = prune_stream_threads(in_fd, out_fd, ring);
+
+#else
+	(void) use_uring;
+	ret = prune_stream_threads(in_fd, out_fd, ring);
+
+#endif
+	stream_ring_free(ring);
+	return ret;
+}
+
+int main(int argc, char** argv) {
+	size_t threads = 0;
+	bool huge = false;
+	bool use_uring = true;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "Huj:h")) != -1) {
+		switch (opt) {
+		case 'H':
+			huge = true;
+			break;
+		case 'u':
+			use_uring = false;
+			break;
+		case 'j':
+			threads = strtoul(optarg, NULL, 10);
+			break;
+		case 'h':
+			usage(stdout);
+			return 0;
+		default:
+			usage(stderr);
+			return 255;
+		}
+	}
+
+	if (argc - optind > 2) {
+		usage(stderr);
+		return 255;
+	}
+
+	char const* const in_name = argc - optind > 0 ? argv[optind] : "-";
+	char const* const out_name = argc - optind > 1 ? argv[optind + 1] : "-";
+
+	int const in_fd = strcmp(in_name, "-") == 0 ? STDIN_FILENO : open(in_name, O_RDONLY);
+
+	if (in_fd < 0) {
+		fprintf(stderr, "error: cannot open %s: %s\n", in_name, strerror(errno));
+		return 1;
+	}
+
+	struct stat in_stat;
+
+	if (fstat(in_fd, &in_stat)) {
+		fprintf(stderr, "error: cannot stat %s: %s\n", in_name, strerror(errno));
+		return 2;
+	}
+
+	// pipes, sockets and ttys have no length to map up front
+	if (!S_ISREG(in_stat.st_mode)) {
+		int const out_fd = strcmp(out_name, "-") == 0 ? STDOUT_FILENO : open(out_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+		if (out_fd < 0) {
+			fprintf(stderr, "error: cannot open %s: %s\n", out_name, strerror(errno));
+			return 4;
+		}
+
+		int const ret = prune_stream(in_fd, out_fd, use_uring, huge);
+
+		if (in_fd != STDIN_FILENO)
+			close(in_fd);
+		if (out_fd != STDOUT_FILENO)
+			close(out_fd);
+
+		return ret;
+	}
+
+	size_t const len = in_stat.st_size;
+	void* src = NULL;
+
+	if (len) {
+		src = mmap(NULL, len, PROT_READ, MAP_PRIVATE, in_fd, 0);
+
+		if (src == MAP_FAILED) {
+			fprintf(stderr, "error: cannot map %s: %s\n", in_name, strerror(errno));
+			return 3;
+		}
+
+		madvise(src, len, MADV_SEQUENTIAL);
+		if (huge)
+			madvise(src, len, MADV_HUGEPAGE);
+	}
+
+	// no O_TRUNC -- the output gets sized once we know it is not the input
+	int const out_fd = strcmp(out_name, "-") == 0 ? STDOUT_FILENO : open(out_name, O_RDWR | O_CREAT, 0644);
+
+	if (out_fd < 0) {
+		fprintf(stderr, "error: cannot open %s: %s\n", out_name, strerror(errno));
+		return 4;
+	}
+
+	struct stat out_stat;
+	bool const regular = fstat(out_fd, &out_stat) == 0 && S_ISREG(out_stat.st_mode);
+
+	if (regular && out_stat.st_dev == in_stat.st_dev && out_stat.st_ino == in_stat.st_ino) {
+		fprintf(stderr, "error: %s is both input and output\n", in_name);
+		return 4;
+	}
+
+	// stdout is usually open write-only, which rules out a shared writable mapping
+	bool const mappable = regular && out_fd != STDOUT_FILENO;
+
+	int const ret = mappable ?
+		prune_to_mapping(static_cast< uint8_t const* >(src), len, out_fd, threads, huge) :
+		prune_to_buffer(static_cast< uint8_t const* >(src), len, out_fd, threads, huge);
+
+	if (len)
+		munmap(src, len);
+
+	if (in_fd != STDIN_FILENO)
+		close(in_fd);
+	if (out_fd != STDOUT_FILENO)
+		close(out_fd);
+
+	return ret;
+}
@@ -0,0 +1,173 @@
+// pruning of blanks from an ascii stream -- the C interface of the shared library, over the header-only pruners; no C++
+// exception may cross into the C caller, so the entry points over std containers and threads catch all, and the rest
+// run over the caller's buffers and function-local statics alone
+#include "ascii_pruner.h"
+#include "ascii_pruner.hpp"
+#include <new>
+
+static_assert(sizeof(ascii_quote_state) == sizeof(quote_state), "ascii_quote_state must match quote_state");
+static_assert(sizeof(ascii_view) == sizeof(prune_view), "ascii_view must match prune_view");
+
+struct ascii_arena {
+	prune_arena arena;
+};
+
+size_t ascii_prune(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst) {
+
+	return prune(src, len, dst);
+}
+
+size_t ascii_prune_in_place(
+	uint8_t* const buf,
+	size_t const len) {
+
+	return prune_in_place(buf, len);
+}
+
+size_t ascii_prune_stream(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst) {
+
+	return prune_stream(src, len, dst);
+}
+
+size_t ascii_prune_parallel(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const threads) {
+
+	try {
+		return prune_parallel(src, len, dst, threads);
+	}
+	catch (...) {
+		return prune(src, len, dst);
+	}
+}
+
+size_t ascii_prune_collapse(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	int* const run) {
+
+	if (run == NULL)
+		return prune_collapse(src, len, dst);
+
+	bool state = *run != 0;
+	size_t const ret = prune_collapse(src, len, dst, state);
+
+	*run = state;
+	return ret;
+}
+
+size_t ascii_prune_json(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	ascii_quote_state* const state) {
+
+	quote_state quotes = { state ? state->in_string : 0, state ? state->escaped : 0 };
+	size_t const ret = prune_quoted< true >(src, len, dst, quotes);
+
+	if (state) {
+		state->in_string = quotes.in_string;
+		state->escaped = quotes.escaped;
+	}
+	return ret;
+}
+
+size_t ascii_prune_csv(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	ascii_quote_state* const state) {
+
+	quote_state quotes = { state ? state->in_string : 0, state ? state->escaped : 0 };
+	size_t const ret = prune_quoted< false >(src, len, dst, quotes);
+
+	if (state) {
+		state->in_string = quotes.in_string;
+		state->escaped = quotes.escaped;
+	}
+	return ret;
+}
+
+size_t ascii_prune_positions(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	uint32_t* const positions) {
+
+	return prune_positions(src, len, dst, positions);
+}
+
+size_t ascii_prune_utf8(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	int* const valid) {
+
+	bool well_formed;
+	size_t const ret = prune_utf8(src, len, dst, well_formed);
+
+	if (valid)
+		*valid = well_formed;
+	return ret;
+}
+
+ascii_arena* ascii_arena_new(
+	size_t const chunk) {
+
+	return new (std::nothrow) ascii_arena { prune_arena(chunk ? chunk : size_t(1) << 20) };
+}
+
+void ascii_arena_free(
+	ascii_arena* const arena) {
+
+	delete arena;
+}
+
+void ascii_arena_reset(
+	ascii_arena* const arena) {
+
+	arena->arena.reset();
+}
+
+size_t ascii_prune_batch(
+	ascii_view const* const in,
+	size_t const n,
+	ascii_arena* const arena,
+	ascii_view* const results) {
+
+	try {
+		return prune_batch(reinterpret_cast< prune_view const* >(in), n, arena->arena,
+			reinterpret_cast< prune_view* >(results));
+	}
+	catch (...) {
+		return size_t(-1);
+	}
+}
+
+size_t ascii_count_kept(
+	uint8_t const* const src,
+	size_t const len) {
+
+	return count_kept(src, len);
+}
+
+void ascii_blank_bitmap(
+	uint8_t const* const src,
+	size_t const len,
+	uint64_t* const out) {
+
+	blank_bitmap(src, len, out);
+}
+
+char const* ascii_pruner_kernel(void) {
+	return prune_kernel_name(prune_default());
+}
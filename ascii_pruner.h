@@ -0,0 +1,138 @@
+// pruning of blanks from an ascii stream -- C interface of the shared library, over ascii_pruner.hpp; a blank is any
+// char not above ' ', and the pruner is the fastest for the CPU at hand, as probed on first use
+#ifndef ASCII_PRUNER_H_
+#define ASCII_PRUNER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+	#define ASCII_PRUNER_API __declspec(dllexport)
+#else
+	#define ASCII_PRUNER_API __attribute__ ((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// state of prune_json/prune_csv between the buffers of a stream; zeroed at the start -- outside of any string
+typedef struct ascii_quote_state {
+	uint64_t in_string;
+	uint64_t escaped;
+} ascii_quote_state;
+
+// a string of len chars at data, as given to ascii_prune_batch() and returned by it
+typedef struct ascii_view {
+	uint8_t const* data;
+	size_t len;
+} ascii_view;
+
+// arena the outputs of ascii_prune_batch() go to; they stay put until the arena is reset or freed
+typedef struct ascii_arena ascii_arena;
+
+// prune all blanks from src[0, len) into dst; returns the count of non-blanks; dst must have room for len chars
+ASCII_PRUNER_API size_t ascii_prune(
+	uint8_t const* src,
+	size_t len,
+	uint8_t* dst);
+
+// prune all blanks from buf[0, len) in place; returns the count of non-blanks, now at the start of buf
+ASCII_PRUNER_API size_t ascii_prune_in_place(
+	uint8_t* buf,
+	size_t len);
+
+// ascii_prune() for outputs too big for the caches, that will not be read back soon: dst gets written past the caches;
+// src and dst must not overlap, and nothing gets written past the non-blanks
+ASCII_PRUNER_API size_t ascii_prune_stream(
+	uint8_t const* src,
+	size_t len,
+	uint8_t* dst);
+
+// ascii_prune() on the given count of threads, zero standing for all hardware threads
+ASCII_PRUNER_API size_t ascii_prune_parallel(
+	uint8_t const* src,
+	size_t len,
+	uint8_t* dst,
+	size_t threads);
+
+// collapse each run of blanks into a single ' '; returns the count of chars written; run, when not NULL, tells whether
+// the char before src was a blank, and is left telling whether the last char of src was one
+ASCII_PRUNER_API size_t ascii_prune_collapse(
+	uint8_t const* src,
+	size_t len,
+	uint8_t* dst,
+	int* run);
+
+// prune the blanks outside of JSON strings; returns the count of chars written; state, when not NULL, carries over
+// from buffer to buffer of a stream
+ASCII_PRUNER_API size_t ascii_prune_json(
+	uint8_t const* src,
+	size_t len,
+	uint8_t* dst,
+	ascii_quote_state* state);
+
+// prune the blanks outside of CSV strings, as ascii_prune_json() does those outside of JSON strings
+ASCII_PRUNER_API size_t ascii_prune_csv(
+	uint8_t const* src,
+	size_t len,
+	uint8_t* dst,
+	ascii_quote_state* state);
+
+// ascii_prune(), writing the offset in src of each char kept to the same index of positions, which must have room for
+// len offsets; the offsets are 32-bit, so len must not exceed 4 GiB -- a larger input is up to the caller to split,
+// the positions of each chunk then being relative to its start
+ASCII_PRUNER_API size_t ascii_prune_positions(
+	uint8_t const* src,
+	size_t len,
+	uint8_t* dst,
+	uint32_t* positions);
+
+// prune all blanks, ASCII and Unicode alike, from the UTF-8 of src[0, len) into dst; returns the count of chars
+// written; valid, when not NULL, tells whether src was well-formed UTF-8 -- ill-formed UTF-8 gets pruned all the same
+ASCII_PRUNER_API size_t ascii_prune_utf8(
+	uint8_t const* src,
+	size_t len,
+	uint8_t* dst,
+	int* valid);
+
+// new arena, growing in chunks of at least the given count of chars, zero standing for 1 MiB; NULL when out of memory
+ASCII_PRUNER_API ascii_arena* ascii_arena_new(
+	size_t chunk);
+
+// free the arena, and all outputs in it; arena may be NULL
+ASCII_PRUNER_API void ascii_arena_free(
+	ascii_arena* arena);
+
+// drop all outputs in the arena, keeping its memory for the next ones
+ASCII_PRUNER_API void ascii_arena_reset(
+	ascii_arena* arena);
+
+// prune all blanks from each of n strings into the arena, one output after the other, and write the view of each
+// output to the same index of results; returns the count of chars written, or (size_t)-1 when out of memory
+ASCII_PRUNER_API size_t ascii_prune_batch(
+	ascii_view const* in,
+	size_t n,
+	ascii_arena* arena,
+	ascii_view* results);
+
+// count of the non-blanks of src[0, len) -- the count of chars ascii_prune() would write
+ASCII_PRUNER_API size_t ascii_count_kept(
+	uint8_t const* src,
+	size_t len);
+
+// bitmap of the non-blanks of src[0, len): bit i % 64 of out[i / 64] is set for a non-blank src[i]; out must have room
+// for (len + 63) / 64 words
+ASCII_PRUNER_API void ascii_blank_bitmap(
+	uint8_t const* src,
+	size_t len,
+	uint64_t* out);
+
+// name of the pruner picked for the CPU at hand, e.g. "testee10"
+ASCII_PRUNER_API char const* ascii_pruner_kernel(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASCII_PRUNER_H_
@@ -0,0 +1,4834 @@
+// pruning of blanks from an ascii stream -- the pruner routines, over caller-supplied buffers
+#ifndef ASCII_PRUNER_HPP_
+#define ASCII_PRUNER_HPP_
+
+#if defined(__ARM_FEATURE_SVE)
+	#include <arm_sve.h>
+#endif
+#if __aarch64__
+	#include <arm_neon.h>
+	#if __linux__
+		#include <sys/auxv.h>
+	#endif
+#elif __x86_64__ || __i386__
+	#include <immintrin.h>
+#endif
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <exception>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if __aarch64__
+	// q-form and d-form of the permutes and pairwise adds coming at the same latency is the norm (A53, Apple); A57 and
+	// A72 are the exceptions. 0 picks the d-form tuning for those two, 1 the q-form one for the rest; either way it is
+	// just the default of unqualified testee07<> and collapse07<> -- the dispatch and the benchmark name the tuning,
+	// < true > for kernel_testee07 and < false > for kernel_testee07_a72, and keep A57 and A72 on testee00
+	#if !defined(SAME_LATENCY_Q_AND_D)
+		#define SAME_LATENCY_Q_AND_D 0
+	#endif
+#elif __x86_64__ || __i386__
+	// amd64 testees are built for their ISA extensions regardless of the codegen flags, so one binary can pick them at
+	// runtime; they still get inlined into callers built for the same extensions, e.g. with -mssse3 -mpopcnt
+	#define PRUNER_TARGET_SSSE3 __attribute__ ((target("ssse3,popcnt")))
+	#define PRUNER_TARGET_AVX2 __attribute__ ((target("avx2,popcnt")))
+	#define PRUNER_TARGET_AVX512VBMI2 __attribute__ ((target("avx512f,avx512bw,avx512vbmi,avx512vbmi2,popcnt")))
+	#define PRUNER_TARGET_BMI2 __attribute__ ((target("ssse3,popcnt,bmi2")))
+	#define PRUNER_TARGET_SSE2 __attribute__ ((target("sse2")))
+#endif
+
+// how far ahead of the batch at hand prune_stream() prefetches its input, in chars; 0 leaves it to the hardware
+// prefetchers, which keep up with a sequential read on the cores measured -- see README.md
+#if !defined(PRUNER_PREFETCH_DISTANCE)
+	#define PRUNER_PREFETCH_DISTANCE 0
+#endif
+
+// a pruner owning its core has the caches to itself, and may keep a lookup table warm in them -- the default of the
+// dispatcher, for builds that run on dedicated cores
+#if !defined(PRUNER_OWNS_CORE)
+	#define PRUNER_OWNS_CORE 0
+#endif
+
+// Blank predicates: which chars a pruner drops, fixed at compile time. Each predicate classifies one char at a time
+// ('scalar', true for a blank), or a whole vector at a time ('mask', all-ones lanes for blanks; on AVX-512 'keep',
+// the mask of non-blanks) -- the testees feed that mask into their compaction as is.
+
+// blanks are the chars not above 'threshold', in the unsigned sense; the default, and what the testees were built for
+template < uint8_t threshold = ' ' >
+struct blank_threshold {
+	static bool scalar(uint8_t const c) {
+		return c <= threshold;
+	}
+
+#if __aarch64__
+	static uint8x16_t mask(uint8x16_t const v) {
+		return vcleq_u8(v, vdupq_n_u8(threshold));
+	}
+
+#elif __x86_64__ || __i386__
+	PRUNER_TARGET_SSE2 static __m128i mask(__m128i const v) {
+		return _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(threshold)), v);
+	}
+
+	PRUNER_TARGET_AVX2 static __m256i mask(__m256i const v) {
+		return _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(threshold)), v);
+	}
+
+	PRUNER_TARGET_AVX512VBMI2 static __mmask64 keep(__m512i const v) {
+		return _mm512_cmpgt_epu8_mask(v, _mm512_set1_epi8(threshold));
+	}
+
+#endif
+};
+
+// blanks are the listed chars, compared for one by one; for a handful of chars, e.g. blank_set< ' ', '\t' >
+template < uint8_t... chars >
+struct blank_set;
+
+template < uint8_t c >
+struct blank_set< c > {
+	static bool scalar(uint8_t const x) {
+		return x == c;
+	}
+
+#if __aarch64__
+	static uint8x16_t mask(uint8x16_t const v) {
+		return vceqq_u8(v, vdupq_n_u8(c));
+	}
+
+#elif __x86_64__ || __i386__
+	PRUNER_TARGET_SSE2 static __m128i mask(__m128i const v) {
+		return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+	}
+
+	PRUNER_TARGET_AVX2 static __m256i mask(__m256i const v) {
+		return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+	}
+
+	PRUNER_TARGET_AVX512VBMI2 static __mmask64 keep(__m512i const v) {
+		return _mm512_cmpneq_epi8_mask(v, _mm512_set1_epi8(c));
+	}
+
+#endif
+};
+
+template < uint8_t c, uint8_t c1, uint8_t... cs >
+struct blank_set< c, c1, cs... > {
+	typedef blank_set< c1, cs... > rest;
+
+	static bool scalar(uint8_t const x) {
+		return x == c || rest::scalar(x);
+	}
+
+#if __aarch64__
+	static uint8x16_t mask(uint8x16_t const v) {
+		return vorrq_u8(vceqq_u8(v, vdupq_n_u8(c)), rest::mask(v));
+	}
+
+#elif __x86_64__ || __i386__
+	PRUNER_TARGET_SSE2 static __m128i mask(__m128i const v) {
+		return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)), rest::mask(v));
+	}
+
+	PRUNER_TARGET_AVX2 static __m256i mask(__m256i const v) {
+		return _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)), rest::mask(v));
+	}
+
+	PRUNER_TARGET_AVX512VBMI2 static __mmask64 keep(__m512i const v) {
+		return _mm512_cmpneq_epi8_mask(v, _mm512_set1_epi8(c)) & rest::keep(v);
+	}
+
+#endif
+};
+
+// word 'w' of the 256-bit class of the chars in 'chars', for use with blank_class, e.g.
+// blank_class< blank_word(0, ",;\n"), blank_word(1, ",;\n"), blank_word(2, ",;\n"), blank_word(3, ",;\n") >
+constexpr uint64_t blank_word(
+	unsigned const w,
+	char const* const chars) {
+
+	return *chars == 0 ? 0 :
+		(uint8_t(*chars) >> 6 == w ? uint64_t(1) << (uint8_t(*chars) & 63) : 0) | blank_word(w, chars + 1);
+}
+
+// the 256-bit map of blank_class, char c at bit c % 64 of word c / 64, along with its nibble-lookup tables: the table
+// of either half of the chars (high nibbles [0, 8) and [8, 16)) has a row of 8 bits per low nibble, one bit per high
+// nibble in that half; 'oct' packs 8 rows of a table into a word, little-endian
+template < uint64_t w0, uint64_t w1, uint64_t w2, uint64_t w3 >
+struct blank_class_map {
+	static constexpr bool bit(unsigned const c) {
+		return ((c < 64 ? w0 : c < 128 ? w1 : c < 192 ? w2 : w3) >> (c & 63) & 1) != 0;
+	}
+
+	static constexpr uint64_t row(
+		unsigned const half,
+		unsigned const lo,
+		unsigned const j = 0) {
+
+		return j == 8 ? 0 : (bit((half + j) * 16 + lo) ? uint64_t(1) << j : 0) | row(half, lo, j + 1);
+	}
+
+	static constexpr uint64_t oct(
+		unsigned const half,
+		unsigned const o,
+		unsigned const k = 0) {
+
+		return k == 8 ? 0 : row(half, o * 8 + k) << k * 8 | oct(half, o, k + 1);
+	}
+};
+
+// blanks are an arbitrary class of chars, given as a 256-bit map. Vectors get classified by nibble lookups: the low
+// nibble of a char picks a row from the table of its half of the chars, and the high nibble picks the bit to test in
+// that row
+template < uint64_t w0, uint64_t w1, uint64_t w2, uint64_t w3 >
+struct blank_class {
+	typedef blank_class_map< w0, w1, w2, w3 > map;
+
+	// the tables as compile-time constants: lower half, upper half
+	static constexpr uint64_t lo0 = map::oct(0, 0);
+	static constexpr uint64_t lo1 = map::oct(0, 1);
+	static constexpr uint64_t hi0 = map::oct(8, 0);
+	static constexpr uint64_t hi1 = map::oct(8, 1);
+
+	static bool scalar(uint8_t const c) {
+		return map::bit(c);
+	}
+
+#if __aarch64__
+	static uint8x16_t mask(uint8x16_t const v) {
+		uint8x16x2_t const tables = { { vcombine_u8(vcreate_u8(lo0), vcreate_u8(lo1)), vcombine_u8(vcreate_u8(hi0), vcreate_u8(hi1)) } };
+
+		// low nibble, plus 16 for the upper half of the chars, which have their table second
+		uint8x16_t const index = vorrq_u8(vandq_u8(v, vdupq_n_u8(0x0f)), vandq_u8(vshrq_n_u8(v, 3), vdupq_n_u8(0x10)));
+		uint8x16_t const row = vqtbl2q_u8(tables, index);
+		uint8x16_t const bit = vqtbl1q_u8(vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201)), vshrq_n_u8(v, 4));
+		return vtstq_u8(row, bit);
+	}
+
+#elif __x86_64__ || __i386__
+	// pshufb zeroes the lanes of index bytes with the top bit set, so each table only answers for its own half
+	PRUNER_TARGET_SSSE3 static __m128i mask(__m128i const v) {
+		__m128i const row = _mm_or_si128(
+			_mm_shuffle_epi8(_mm_set_epi64x(lo1, lo0), v),
+			_mm_shuffle_epi8(_mm_set_epi64x(hi1, hi0), _mm_xor_si128(v, _mm_set1_epi8(-128))));
+		__m128i const hi = _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0f));
+		__m128i const bit = _mm_shuffle_epi8(_mm_set1_epi64x(0x8040201008040201), hi);
+		return _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+	}
+
+	PRUNER_TARGET_AVX2 static __m256i mask(__m256i const v) {
+		__m256i const row = _mm256_or_si256(
+			_mm256_shuffle_epi8(_mm256_set_epi64x(lo1, lo0, lo1, lo0), v),
+			_mm256_shuffle_epi8(_mm256_set_epi64x(hi1, hi0, hi1, hi0), _mm256_xor_si256(v, _mm256_set1_epi8(-128))));
+		__m256i const hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0f));
+		__m256i const bit = _mm256_shuffle_epi8(_mm256_set1_epi64x(0x8040201008040201), hi);
+		return _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+	}
+
+	PRUNER_TARGET_AVX512VBMI2 static __mmask64 keep(__m512i const v) {
+		__m512i const row = _mm512_or_si512(
+			_mm512_shuffle_epi8(_mm512_set4_epi64(lo1, lo0, lo1, lo0), v),
+			_mm512_shuffle_epi8(_mm512_set4_epi64(hi1, hi0, hi1, hi0), _mm512_xor_si512(v, _mm512_set1_epi8(-128))));
+		__m512i const hi = _mm512_and_si512(_mm512_srli_epi16(v, 4), _mm512_set1_epi8(0x0f));
+		__m512i const bit = _mm512_shuffle_epi8(_mm512_set1_epi64(0x8040201008040201), hi);
+		return _mm512_testn_epi8_mask(row, bit);
+	}
+
+#endif
+};
+
+// Every testee consumes one batch (16, 32 or 64 chars) from 'input' and writes the non-blanks from that batch to
+// 'output', returning their count. Past the returned count the testees may write garbage, up to a full batch from
+// 'output' -- callers must provide that much room. A blank is any char not above ' ', in the unsigned sense; the
+// testees taking a 'blank' predicate drop its blanks instead. The testees read their entire batch before their first
+// store, so 'output' may trail 'input' in the same buffer.
+
+// fully-scalar version; good performance on both amd64 and arm64 above-entry-level parts;
+// particularly on cortex-a72 this does an IPC of 2.94 which is excellent! ryzen also
+// does an IPC above 4, which is remarkable
+template < class blank = blank_threshold<> >
+inline size_t testee00(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	size_t i = 0, pos = 0;
+	while (i < 16) {
+		uint8_t const c = input[i++];
+		output[pos] = c;
+		pos += (blank::scalar(c) ? 0 : 1);
+	}
+	return pos;
+}
+
+#if __aarch64__
+// naive pruner, 16-batch; filter single blank from N input chars, followed by K optional trailing blanks, N + K = batch size
+// example: "1234 678  " -> "1234678" (N + K = 10)
+inline size_t testee01(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	uint8x16_t const vinput = vld1q_u8(input);
+	uint8x16_t prfsum = vcleq_u8(vinput, vdupq_n_u8(' '));
+
+	// pick one:
+	// before computing the prefix sum: count_of_blanks := vaddvq_u8(prfsum)
+	// after computing the prefix sum: count_of_blanks := prfsum[last_lane]
+	prfsum = vaddq_u8(prfsum, vextq_u8(vdupq_n_u8(0), prfsum, 16 - 1));
+	prfsum = vaddq_u8(prfsum, vextq_u8(vdupq_n_u8(0), prfsum, 16 - 2));
+	prfsum = vaddq_u8(prfsum, vextq_u8(vdupq_n_u8(0), prfsum, 16 - 4));
+	prfsum = vaddq_u8(prfsum, vextq_u8(vdupq_n_u8(0), prfsum, 16 - 8));
+
+	int8_t const bnum = vgetq_lane_u8(prfsum, 15);
+
+	uint8x16_t const index = vsubq_u8((uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 }, prfsum);
+	uint8x16_t const res = vqtbl1q_u8(vinput, index);
+
+	vst1q_u8(output, res);
+	return sizeof(uint8x16_t) + bnum;
+}
+
+// naive pruner, 32-batch; filter single blank from N input chars, followed by K optional trailing blanks, N + K = half batch size
+// example: "1234 678  " -> "1234678" (N + K = 10)
+inline size_t testee02(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	uint8x16_t const vinput0 = vld1q_u8(input);
+	uint8x16_t const vinput1 = vld1q_u8(input + sizeof(uint8x16_t));
+	uint8x16_t prfsum0 = vcleq_u8(vinput0, vdupq_n_u8(' '));
+	uint8x16_t prfsum1 = vcleq_u8(vinput1, vdupq_n_u8(' '));
+
+	// pick one:
+	// before computing the prefix sum: count_of_blanks := vaddvq_u8(prfsum)
+	// after computing the prefix sum: count_of_blanks := prfsum[last_lane]
+	prfsum0 = vaddq_u8(prfsum0, vextq_u8(vdupq_n_u8(0), prfsum0, 16 - 1));
+	prfsum1 = vaddq_u8(prfsum1, vextq_u8(vdupq_n_u8(0), prfsum1, 16 - 1));
+	prfsum0 = vaddq_u8(prfsum0, vextq_u8(vdupq_n_u8(0), prfsum0, 16 - 2));
+	prfsum1 = vaddq_u8(prfsum1, vextq_u8(vdupq_n_u8(0), prfsum1, 16 - 2));
+	prfsum0 = vaddq_u8(prfsum0, vextq_u8(vdupq_n_u8(0), prfsum0, 16 - 4));
+	prfsum1 = vaddq_u8(prfsum1, vextq_u8(vdupq_n_u8(0), prfsum1, 16 - 4));
+	prfsum0 = vaddq_u8(prfsum0, vextq_u8(vdupq_n_u8(0), prfsum0, 16 - 8));
+	prfsum1 = vaddq_u8(prfsum1, vextq_u8(vdupq_n_u8(0), prfsum1, 16 - 8));
+
+	int8_t const bnum0 = vgetq_lane_u8(prfsum0, 15);
+	int8_t const bnum1 = vgetq_lane_u8(prfsum1, 15);
+
+	uint8x16_t const index0 = vsubq_u8((uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 }, prfsum0);
+	uint8x16_t const index1 = vsubq_u8((uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 }, prfsum1);
+	uint8x16_t const res0 = vqtbl1q_u8(vinput0, index0);
+	uint8x16_t const res1 = vqtbl1q_u8(vinput1, index1);
+
+	vst1q_u8(output, res0);
+	vst1q_u8(output + sizeof(uint8x16_t) + bnum0, res1);
+	return sizeof(uint8x16_t) * 2 + bnum0 + bnum1;
+}
+
+#elif __x86_64__ || __i386__
+// naive pruner, 16-batch; filter single blank from N input chars, followed by K optional trailing blanks, N + K = batch size
+// example: "1234 678  " -> "1234678" (N + K = 10)
+PRUNER_TARGET_SSSE3 inline size_t testee01(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	__m128i const vinput = _mm_loadu_si128(reinterpret_cast< const __m128i* >(input));
+	__m128i prfsum = _mm_cmpeq_epi8(_mm_min_epu8(vinput, _mm_set1_epi8(' ')), vinput);
+
+	// pick one:
+	// before computing the prefix sum: count_of_blanks := _mm_popcnt_u32(_mm_movemask_epi8(prfsum))
+	// after computing the prefix sum: count_of_blanks := prfsum[last_lane]
+	prfsum = _mm_add_epi8(prfsum, _mm_slli_si128(prfsum, 1));
+	prfsum = _mm_add_epi8(prfsum, _mm_slli_si128(prfsum, 2));
+	prfsum = _mm_add_epi8(prfsum, _mm_slli_si128(prfsum, 4));
+	prfsum = _mm_add_epi8(prfsum, _mm_slli_si128(prfsum, 8));
+
+	int8_t const bnum = uint16_t(_mm_extract_epi16(prfsum, 7)) >> 8;
+
+	__m128i const index = _mm_sub_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), prfsum);
+	__m128i const res = _mm_shuffle_epi8(vinput, index);
+
+	_mm_storeu_si128(reinterpret_cast< __m128i* >(output), res);
+	return sizeof(__m128i) + bnum;
+}
+
+// naive pruner, 32-batch; filter single blank from N input chars, followed by K optional trailing blanks, N + K = half batch size
+// example: "1234 678  " -> "1234678" (N + K = 10)
+PRUNER_TARGET_SSSE3 inline size_t testee02(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	__m128i const vinput0 = _mm_loadu_si128(reinterpret_cast< const __m128i* >(input));
+	__m128i const vinput1 = _mm_loadu_si128(reinterpret_cast< const __m128i* >(input) + 1);
+	__m128i prfsum0 = _mm_cmpeq_epi8(_mm_min_epu8(vinput0, _mm_set1_epi8(' ')), vinput0);
+	__m128i prfsum1 = _mm_cmpeq_epi8(_mm_min_epu8(vinput1, _mm_set1_epi8(' ')), vinput1);
+
+	// pick one:
+	// before computing the prefix sum: count_of_blanks := _mm_popcnt_u32(_mm_movemask_epi8(prfsum))
+	// after computing the prefix sum: count_of_blanks := prfsum[last_lane]
+	prfsum0 = _mm_add_epi8(prfsum0, _mm_slli_si128(prfsum0, 1));
+	prfsum1 = _mm_add_epi8(prfsum1, _mm_slli_si128(prfsum1, 1));
+	prfsum0 = _mm_add_epi8(prfsum0, _mm_slli_si128(prfsum0, 2));
+	prfsum1 = _mm_add_epi8(prfsum1, _mm_slli_si128(prfsum1, 2));
+	prfsum0 = _mm_add_epi8(prfsum0, _mm_slli_si128(prfsum0, 4));
+	prfsum1 = _mm_add_epi8(prfsum1, _mm_slli_si128(prfsum1, 4));
+	prfsum0 = _mm_add_epi8(prfsum0, _mm_slli_si128(prfsum0, 8));
+	prfsum1 = _mm_add_epi8(prfsum1, _mm_slli_si128(prfsum1, 8));
+
+	int8_t const bnum0 = uint16_t(_mm_extract_epi16(prfsum0, 7)) >> 8;
+	int8_t const bnum1 = uint16_t(_mm_extract_epi16(prfsum1, 7)) >> 8;
+
+	__m128i const index0 = _mm_sub_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), prfsum0);
+	__m128i const index1 = _mm_sub_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), prfsum1);
+	__m128i const res0 = _mm_shuffle_epi8(vinput0, index0);
+	__m128i const res1 = _mm_shuffle_epi8(vinput1, index1);
+
+	_mm_storeu_si128(reinterpret_cast< __m128i* >(output), res0);
+	_mm_storeu_si128(reinterpret_cast< __m128i* >(output + sizeof(__m128i) + bnum0), res1);
+	return sizeof(__m128i) * 2 + bnum0 + bnum1;
+}
+
+// pruner semi, 16-batch; replace blanks with the next non-blank, cutting off trailing blanks from the batch
+// example: "1234 678  " -> "12346678"
+PRUNER_TARGET_SSSE3 inline size_t testee03(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	__m128i const vin = _mm_loadu_si128(reinterpret_cast< const __m128i* >(input));
+
+	// discover non-blanks
+	__m128i const pos = _mm_cmpeq_epi8(_mm_max_epu8(vin, _mm_set1_epi8(' ' + 1)), vin);
+
+	// mark blanks as ones
+	__m128i const spc = _mm_andnot_si128(pos, _mm_set1_epi8(1));
+
+	// prefix-sum the blanks, right to left
+	__m128i prfsum = spc;
+	prfsum = _mm_add_epi8(prfsum, _mm_srli_si128(prfsum, 1));
+	prfsum = _mm_add_epi8(prfsum, _mm_srli_si128(prfsum, 2));
+	prfsum = _mm_add_epi8(prfsum, _mm_srli_si128(prfsum, 4));
+	prfsum = _mm_add_epi8(prfsum, _mm_srli_si128(prfsum, 8));
+
+	// isolate sequences of blanks and count their individual lengths, right to left, using a prefix max and the above prefix sum
+	__m128i prfmax = _mm_and_si128(pos, prfsum);
+	prfmax = _mm_max_epu8(prfmax, _mm_srli_si128(prfmax, 1));
+	prfmax = _mm_max_epu8(prfmax, _mm_srli_si128(prfmax, 2));
+	prfmax = _mm_max_epu8(prfmax, _mm_srli_si128(prfmax, 4));
+	prfmax = _mm_max_epu8(prfmax, _mm_srli_si128(prfmax, 8));
+	prfmax = _mm_sub_epi8(prfsum, prfmax);
+
+	// add blank counts to a sequential index to get non-blanks index
+	__m128i const index = _mm_add_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), prfmax);
+
+	// cap trailing out-of-bounds in the index
+	__m128i const indey = _mm_or_si128(index, _mm_cmpgt_epi8(index, _mm_set1_epi8(15)));
+
+	// use the index to fetch all non-blanks from the dictionary
+	__m128i const res = _mm_shuffle_epi8(vin, indey);
+
+	_mm_storeu_si128(reinterpret_cast< __m128i* >(output), res);
+	return sizeof(__m128i) - _mm_popcnt_u32(_mm_movemask_epi8(indey));
+}
+
+#endif
+// From here on start the proper pruners. They all implement the following idea:
+//
+//  1. Get the unperturbed index of all elements of a vector, e.g. { 0, 1, 2, 3, 4, 5, 6, 7 } for an 8-element vector
+//  2. For all blank lanes in the input ascii vector, raise the corresponding lanes in the index vector to MAX_INT, e.g. { 0, 1, 0xff, 3, 0xff, 0xff, 6, 7 }
+//  3. Sort the resulting index vector in ascending order, e.g. { 0, 1, 3, 6, 7, 0xff, 0xff, 0xff }
+//
+// This is the desired index by which to sample the original input vector. That's all.
+
+#if __aarch64__
+// pruner proper, 16-batch; q-form (128-bit regs) half-utilized
+template < class blank = blank_threshold<> >
+inline size_t testee04(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	uint8x16_t const vin = vld1q_u8(input);
+	uint8x16_t const bmask = blank::mask(vin);
+
+	// OR the mask of all blanks with the original index of the vector
+	uint8x16_t const risen = vorrq_u8(bmask, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
+
+	// now just sort that 'risen' to get the desired index of all non-blanks in the front, and all blanks in the back
+
+	// 16-element sorting network: http://pages.ripco.net/~jgamble/nw.html -- 'Best version'
+	// stage 0
+	uint8x16_t const st0a = vqtbl1q_u8(risen, (uint8x16_t) { 0, 2, 4, 6, 8, 10, 12, 14, });
+	uint8x16_t const st0b = vqtbl1q_u8(risen, (uint8x16_t) { 1, 3, 5, 7, 9, 11, 13, 15, });
+	uint8x16_t const st0min = vminq_u8(st0a, st0b); //  0,  2,  4,  6,  8, 10, 12, 14
+	uint8x16_t const st0max = vmaxq_u8(st0a, st0b); //  1,  3,  5,  7,  9, 11, 13, 15
+
+	// stage 1
+	uint8x16x2_t const st0 = { { st0min, st0max } };
+	uint8x16_t const st1a = vqtbl2q_u8(st0, (uint8x16_t) { 0, 2, 4, 6, 16, 18, 20, 22, });
+	uint8x16_t const st1b = vqtbl2q_u8(st0, (uint8x16_t) { 1, 3, 5, 7, 17, 19, 21, 23, });
+	uint8x16_t const st1min = vminq_u8(st1a, st1b); //  0,  4,  8, 12,  1,  5,  9, 13
+	uint8x16_t const st1max = vmaxq_u8(st1a, st1b); //  2,  6, 10, 14,  3,  7, 11, 15
+
+	// stage 2
+	uint8x16x2_t const st1 = { { st1min, st1max } };
+	uint8x16_t const st2a = vqtbl2q_u8(st1, (uint8x16_t) { 0, 2, 4, 6, 16, 18, 20, 22, });
+	uint8x16_t const st2b = vqtbl2q_u8(st1, (uint8x16_t) { 1, 3, 5, 7, 17, 19, 21, 23, });
+	uint8x16_t const st2min = vminq_u8(st2a, st2b); //  0,  8,  1,  9,  2, 10,  3, 11
+	uint8x16_t const st2max = vmaxq_u8(st2a, st2b); //  4, 12,  5, 13,  6, 14,  7, 15
+
+	// stage 3
+	uint8x16x2_t const st2 = { { st2min, st2max } };
+	uint8x16_t const st3a = vqtbl2q_u8(st2, (uint8x16_t) { 0, 2, 4, 6, 16, 18, 20, 22, });
+	uint8x16_t const st3b = vqtbl2q_u8(st2, (uint8x16_t) { 1, 3, 5, 7, 17, 19, 21, 23, });
+	uint8x16_t const st3min = vminq_u8(st3a, st3b); // 0, 1,  2,  3,  4,  5,  6,  7
+	uint8x16_t const st3max = vmaxq_u8(st3a, st3b); // 8, 9, 10, 11, 12, 13, 14, 15
+
+	// from here on some indices are already done -- freeze them, by keeping them in deterministic positions
+
+	// stage 4; indices done so far: 0, 15
+	uint8x16x2_t const st3 = { { st3min, st3max } };
+	uint8x16_t const st4a = vqtbl2q_u8(st3, (uint8x16_t) {  0,  5,  6,  3, 21,  7, 1,  4, });
+	uint8x16_t const st4b = vqtbl2q_u8(st3, (uint8x16_t) { 23, 18, 17, 20, 22, 19, 2, 16, });
+	uint8x16_t const st4min = vminq_u8(st4a, st4b); // [ 0],  5,  6,  3, 13,  7,  1,  4
+	uint8x16_t const st4max = vmaxq_u8(st4a, st4b); // [15], 10,  9, 12, 14, 11,  2,  8
+
+	// stage 5; done so far: 0, 15; temp frozen: 3, 12
+	uint8x16x2_t const st4 = { { st4min, st4max } };
+	uint8x16_t const st5a = vqtbl2q_u8(st4, (uint8x16_t) {  0,  3, 6, 5, 22, 21, 1, 18, });
+	uint8x16_t const st5b = vqtbl2q_u8(st4, (uint8x16_t) { 16, 19, 7, 4, 23, 20, 2, 17, });
+	uint8x16_t const st5min = vminq_u8(st5a, st5b); // [ 0], [ 3], 1,  7, 2, 11, 5,  9
+	uint8x16_t const st5max = vmaxq_u8(st5a, st5b); // [15], [12], 4, 13, 8, 14, 6, 10
+
+	// stage 6; done so far: 0, 1, 14, 15; temp frozen: 5, 6, 9, 10
+	uint8x16x2_t const st5 = { { st5min, st5max } };
+	uint8x16_t const st6a = vqtbl2q_u8(st5, (uint8x16_t) {  0,  2,  4,  5,  1,  3,  6,  7, });
+	uint8x16_t const st6b = vqtbl2q_u8(st5, (uint8x16_t) { 16, 21, 18, 19, 20, 17, 22, 23, });
+	uint8x16_t const st6min = vminq_u8(st6a, st6b); // [ 0], [ 1], 2, 11, 3,  7, [5], [ 9]
+	uint8x16_t const st6max = vmaxq_u8(st6a, st6b); // [15], [14], 4, 13, 8, 12, [6], [10]
+
+	// stage 7; done so far: 0, 1, 2, 13, 14, 15; temp frozen: 4, 11
+	uint8x16x2_t const st6 = { { st6min, st6max } };
+	uint8x16_t const st7a = vqtbl2q_u8(st6, (uint8x16_t) {  0,  1,  2,  3, 22, 23, 4, 5, });
+	uint8x16_t const st7b = vqtbl2q_u8(st6, (uint8x16_t) { 16, 17, 18, 19, 20, 21, 6, 7, });
+	uint8x16_t const st7min = vminq_u8(st7a, st7b); // [ 0], [ 1], [2], [11], 6, 10, 3, 7
+	uint8x16_t const st7max = vmaxq_u8(st7a, st7b); // [15], [14], [4], [13], 8, 12, 5, 9
+
+	// stage 8; done so far: 0, 1, 2, 13, 14, 15
+	uint8x16x2_t const st7 = { { st7min, st7max } };
+	uint8x16_t const st8a = vqtbl2q_u8(st7, (uint8x16_t) {  0,  1,  2,  6, 22,  7, 23,  3, });
+	uint8x16_t const st8b = vqtbl2q_u8(st7, (uint8x16_t) { 16, 17, 19, 18,  4, 20,  5, 21, });
+	uint8x16_t const st8min = vminq_u8(st8a, st8b); // [ 0], [ 1], [ 2], 3, 5, 7,  9, 11
+	uint8x16_t const st8max = vmaxq_u8(st8a, st8b); // [15], [14], [13], 4, 6, 8, 10, 12
+
+	// stage 9; done so far: 0, 1, 2, 3, 4, 5, 10, 11, 12, 13, 14, 15
+	uint8x16x2_t const st8 = { { st8min, st8max } };
+	uint8x16_t const st9a = vqtbl2q_u8(st8, (uint8x16_t) {  0,  1,  2,  3, 19,  4, 20, 21, });
+	uint8x16_t const st9b = vqtbl2q_u8(st8, (uint8x16_t) { 16, 17, 18, 23,  7, 22,  5,  6, });
+	uint8x16_t const st9min = vminq_u8(st9a, st9b); // [ 0], [ 1], [ 2], [ 3], [ 4], [ 5], 6, 8
+	uint8x16_t const st9max = vmaxq_u8(st9a, st9b); // [15], [14], [13], [12], [11], [10], 7, 9
+
+	uint8x16x2_t const st9 = { { st9min, st9max } };
+	uint8x16_t const index = vqtbl2q_u8(st9, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 22, 7, 23, 21, 20, 19, 18, 17, 16 });
+
+	uint8x16_t const res = vqtbl1q_u8(vin, index);
+	vst1q_u8(output, res);
+	return sizeof(uint8x16_t) + int8_t(vaddvq_u8(bmask));
+}
+
+// pruner proper, 16-batch; d-form (64-bit regs) version of testee04
+template < class blank = blank_threshold<> >
+inline size_t testee05(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	uint8x16_t const vin = vld1q_u8(input);
+	uint8x16_t const bmask = blank::mask(vin);
+
+	// OR the mask of all blanks with the original index of the vector
+	uint8x16_t const risen = vorrq_u8(bmask, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
+
+	// now just sort that 'risen' to get the desired index of all non-blanks in the front, and all blanks in the back
+
+	// 16-element sorting network: http://pages.ripco.net/~jgamble/nw.html -- 'Best version'
+	// stage 0
+	uint8x8_t const st0a = vqtbl1_u8(risen, (uint8x8_t) { 0, 2, 4, 6, 8, 10, 12, 14 });
+	uint8x8_t const st0b = vqtbl1_u8(risen, (uint8x8_t) { 1, 3, 5, 7, 9, 11, 13, 15 });
+	uint8x8_t const st0min = vmin_u8(st0a, st0b); //  0,  2,  4,  6,  8, 10, 12, 14
+	uint8x8_t const st0max = vmax_u8(st0a, st0b); //  1,  3,  5,  7,  9, 11, 13, 15
+
+	// stage 1
+	uint8x8x2_t const st0 = { { st0min, st0max } };
+	uint8x8_t const st1a = vtbl2_u8(st0, (uint8x8_t) { 0, 2, 4, 6, 8, 10, 12, 14 });
+	uint8x8_t const st1b = vtbl2_u8(st0, (uint8x8_t) { 1, 3, 5, 7, 9, 11, 13, 15 });
+	uint8x8_t const st1min = vmin_u8(st1a, st1b); //  0,  4,  8, 12,  1,  5,  9, 13
+	uint8x8_t const st1max = vmax_u8(st1a, st1b); //  2,  6, 10, 14,  3,  7, 11, 15
+
+	// stage 2
+	uint8x8x2_t const st1 = { { st1min, st1max } };
+	uint8x8_t const st2a = vtbl2_u8(st1, (uint8x8_t) { 0, 2, 4, 6, 8, 10, 12, 14 });
+	uint8x8_t const st2b = vtbl2_u8(st1, (uint8x8_t) { 1, 3, 5, 7, 9, 11, 13, 15 });
+	uint8x8_t const st2min = vmin_u8(st2a, st2b); //  0,  8,  1,  9,  2, 10,  3, 11
+	uint8x8_t const st2max = vmax_u8(st2a, st2b); //  4, 12,  5, 13,  6, 14,  7, 15
+
+	// stage 3
+	uint8x8x2_t const st2 = { { st2min, st2max } };
+	uint8x8_t const st3a = vtbl2_u8(st2, (uint8x8_t) { 0, 2, 4, 6, 8, 10, 12, 14 });
+	uint8x8_t const st3b = vtbl2_u8(st2, (uint8x8_t) { 1, 3, 5, 7, 9, 11, 13, 15 });
+	uint8x8_t const st3min = vmin_u8(st3a, st3b); // 0, 1,  2,  3,  4,  5,  6,  7
+	uint8x8_t const st3max = vmax_u8(st3a, st3b); // 8, 9, 10, 11, 12, 13, 14, 15
+
+	// from here on some indices are already done -- freeze them, by keeping them in deterministic positions
+
+	// stage 4; indices done so far: 0, 15
+	uint8x8x2_t const st3 = { { st3min, st3max } };
+	uint8x8_t const st4a = vtbl2_u8(st3, (uint8x8_t) {  0,  5,  6,  3, 13,  7,  1,  4 });
+	uint8x8_t const st4b = vtbl2_u8(st3, (uint8x8_t) { 15, 10,  9, 12, 14, 11,  2,  8 });
+	uint8x8_t const st4min = vmin_u8(st4a, st4b); // [ 0],  5,  6,  3, 13,  7,  1,  4
+	uint8x8_t const st4max = vmax_u8(st4a, st4b); // [15], 10,  9, 12, 14, 11,  2,  8
+
+	// stage 5; done so far: 0, 15; temp frozen: 3, 12
+	uint8x8x2_t const st4 = { { st4min, st4max } };
+	uint8x8_t const st5a = vtbl2_u8(st4, (uint8x8_t) {  0,    3, 6,  5, 14, 13, 1, 10 });
+	uint8x8_t const st5b = vtbl2_u8(st4, (uint8x8_t) {  8,   11, 7,  4, 15, 12, 2,  9 });
+	uint8x8_t const st5min = vmin_u8(st5a, st5b); // [ 0], [ 3], 1,  7,  2, 11, 5,  9
+	uint8x8_t const st5max = vmax_u8(st5a, st5b); // [15], [12], 4, 13,  8, 14, 6, 10
+
+	// stage 6; done so far: 0, 1, 14, 15; temp frozen: 5, 6, 9, 10
+	uint8x8x2_t const st5 = { { st5min, st5max } };
+	uint8x8_t const st6a = vtbl2_u8(st5, (uint8x8_t) {  0,   2,  4,  5,  1,  3,  6,    7 });
+	uint8x8_t const st6b = vtbl2_u8(st5, (uint8x8_t) {  8,  13, 10, 11, 12,  9, 14,   15 });
+	uint8x8_t const st6min = vmin_u8(st6a, st6b); // [ 0], [ 1], 2, 11,  3,  7, [5], [ 9]
+	uint8x8_t const st6max = vmax_u8(st6a, st6b); // [15], [14], 4, 13,  8, 12, [6], [10]
+
+	// stage 7; done so far: 0, 1, 2, 13, 14, 15; temp frozen: 4, 11
+	uint8x8x2_t const st6 = { { st6min, st6max } };
+	uint8x8_t const st7a = vtbl2_u8(st6, (uint8x8_t) {  0,   1,    2,    3, 14, 15, 4, 5 });
+	uint8x8_t const st7b = vtbl2_u8(st6, (uint8x8_t) {  8,   9,   10,   11, 12, 13, 6, 7 });
+	uint8x8_t const st7min = vmin_u8(st7a, st7b); // [ 0], [ 1], [2], [11],  6, 10, 3, 7
+	uint8x8_t const st7max = vmax_u8(st7a, st7b); // [15], [14], [4], [13],  8, 12, 5, 9
+
+	// stage 8; done so far: 0, 1, 2, 13, 14, 15
+	uint8x8x2_t const st7 = { { st7min, st7max } };
+	uint8x8_t const st8a = vtbl2_u8(st7, (uint8x8_t) {  0,   1,    2,   6, 14,  7, 15,  3 });
+	uint8x8_t const st8b = vtbl2_u8(st7, (uint8x8_t) {  8,   9,   11,  10,  4, 12,  5, 13 });
+	uint8x8_t const st8min = vmin_u8(st8a, st8b); // [ 0], [ 1], [ 2],  3,  5,  7,  9, 11
+	uint8x8_t const st8max = vmax_u8(st8a, st8b); // [15], [14], [13],  4,  6,  8, 10, 12
+
+	// stage 9; done so far: 0, 1, 2, 3, 4, 5, 10, 11, 12, 13, 14, 15
+	uint8x8x2_t const st8 = { { st8min, st8max } };
+	uint8x8_t const st9a = vtbl2_u8(st8, (uint8x8_t) {  0,    1,    2,    3,   11,    4, 12, 13 });
+	uint8x8_t const st9b = vtbl2_u8(st8, (uint8x8_t) {  8,    9,   10,   15,    7,   14,  5,  6 });
+	uint8x8_t const st9min = vmin_u8(st9a, st9b); // [ 0], [ 1], [ 2], [ 3], [ 4], [ 5],  6,  8
+	uint8x8_t const st9max = vmax_u8(st9a, st9b); // [15], [14], [13], [12], [11], [10],  7,  9
+
+	uint8x16_t const st9 = vcombine_u8(st9min, st9max);
+	uint8x16_t const index = vqtbl1q_u8(st9, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 14, 7, 15, 13, 12, 11, 10, 9, 8 });
+
+	uint8x16_t const res = vqtbl1q_u8(vin, index);
+	vst1q_u8(output, res);
+	return sizeof(uint8x16_t) + int8_t(vaddvq_u8(bmask));
+}
+
+// pruner proper, 16-batch; replicates testee04/amd64
+template < class blank = blank_threshold<> >
+inline size_t testee06(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	uint8x16_t const vin = vld1q_u8(input);
+	uint8x16_t const bmask = blank::mask(vin);
+
+	// get the count of non-blanks for each 4-batch
+	uint8x16_t const cmask = vaddq_u8(bmask, vdupq_n_u8(1));
+	uint8x16_t const lena = vpaddq_u8(cmask, cmask);
+	uint8x16_t const lenb = vpaddq_u8(lena, lena);
+	size_t const len0 = vgetq_lane_u8(lenb, 0);
+	size_t const len1 = vgetq_lane_u8(lenb, 1);
+	size_t const len2 = vgetq_lane_u8(lenb, 2);
+	size_t const len3 = vgetq_lane_u8(lenb, 3);
+
+	// OR the mask of all blanks with the original index of the vector
+	uint8x16_t const risen = vorrq_u8(bmask, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
+
+	// now just sort that 'risen' to get the desired index of all non-blanks in the front, and all blanks in the back;
+	// an observation: we don't need to sort the entire risen index as a whole, we can sort it piece-wise
+
+	// 4-element sorting network: http://pages.ripco.net/~jgamble/nw.html -- 'Best version', 4 clusters of
+	//
+	//  [[0,1],[2,3]]  [[4,5],[6,7]]  [[8,9],[a,b]]  [[c,d],[e,f]]
+	//  [[0,2],[1,3]]  [[4,6],[5,7]]  [[8,a],[9,b]]  [[c,e],[d,f]]
+	//  [[1,2]]        [[5,6]]        [[9,a]]        [[d,e]]
+	//
+
+	uint8x8_t const st0a = vget_low_u8(vuzp1q_u8(risen, risen));
+	uint8x8_t const st0b = vget_low_u8(vuzp2q_u8(risen, risen));
+	uint8x8_t const st0min = vmin_u8(st0a, st0b); // 0, 2, 4, 6, 8, a, c, e
+	uint8x8_t const st0max = vmax_u8(st0a, st0b); // 1, 3, 5, 7, 9, b, d, f
+
+	uint8x8_t const st1a = vtrn1_u8(st0min, st0max);
+	uint8x8_t const st1b = vtrn2_u8(st0min, st0max);
+	uint8x8_t const st1min = vmin_u8(st1a, st1b); // 0, 1, 4, 5, 8, 9, c, d
+	uint8x8_t const st1max = vmax_u8(st1a, st1b); // 2, 3, 6, 7, a, b, e, f
+
+	uint8x8_t const st2a =           st1min;
+	uint8x8_t const st2b = vrev16_u8(st1max);
+	uint8x8_t const st2min = vmin_u8(st2a, st2b); // [0], 1, [4], 5, [8], 9, [c], d
+	uint8x8_t const st2max = vmax_u8(st2a, st2b); // [3], 2, [7], 6, [b], a, [f], e
+
+	uint8x16_t const index = vreinterpretq_u8_u16(vzip1q_u16(
+		vreinterpretq_u16_u8(vcombine_u8(          st2min,  vdup_n_u8(0))),
+		vreinterpretq_u16_u8(vcombine_u8(vrev16_u8(st2max), vdup_n_u8(0)))));
+
+	uint8x16_t const res = vqtbl1q_u8(vin, index);
+
+	*reinterpret_cast< uint32_t* >(output)                      = vgetq_lane_u32(vreinterpretq_u32_u8(res), 0);
+	*reinterpret_cast< uint32_t* >(output + len0)               = vgetq_lane_u32(vreinterpretq_u32_u8(res), 1);
+	*reinterpret_cast< uint32_t* >(output + len0 + len1)        = vgetq_lane_u32(vreinterpretq_u32_u8(res), 2);
+	*reinterpret_cast< uint32_t* >(output + len0 + len1 + len2) = vgetq_lane_u32(vreinterpretq_u32_u8(res), 3);
+	return len0 + len1 + len2 + len3;
+}
+
+// compaction of testee07: the non-blanks of vin0:vin1 as per bmask0:bmask1, to output
+template < bool same_latency_q_and_d >
+inline size_t testee07_compact(
+	uint8x16_t const vin0,
+	uint8x16_t const vin1,
+	uint8x16_t const bmask0,
+	uint8x16_t const bmask1,
+	uint8_t* const output) {
+	// get the count of non-blanks for each 4-batch
+	uint8x16_t const cmask0 = vaddq_u8(bmask0, vdupq_n_u8(1));
+	uint8x16_t const cmask1 = vaddq_u8(bmask1, vdupq_n_u8(1));
+
+	size_t len0, len1, len2, len3, len4, len5, len6, len7;
+
+	if (same_latency_q_and_d) {
+		uint8x16_t const lena = vpaddq_u8(cmask0, cmask1);
+		uint8x16_t const lenb = vpaddq_u8(lena, lena);
+
+		len0 = vgetq_lane_u8(lenb, 0);
+		len1 = vgetq_lane_u8(lenb, 1);
+		len2 = vgetq_lane_u8(lenb, 2);
+		len3 = vgetq_lane_u8(lenb, 3);
+		len4 = vgetq_lane_u8(lenb, 4);
+		len5 = vgetq_lane_u8(lenb, 5);
+		len6 = vgetq_lane_u8(lenb, 6);
+		len7 = vgetq_lane_u8(lenb, 7);
+	}
+	else { // when q-form of the instruction comes at extra latency (e.g. A72) use d-form instead, doubling the op count but utilizing co-issue for a net reduced latency
+		uint8x8_t const lena0 = vpadd_u8(vget_low_u8(cmask0), vget_high_u8(cmask0));
+		uint8x8_t const lena1 = vpadd_u8(vget_low_u8(cmask1), vget_high_u8(cmask1));
+		uint8x8_t const lenb0 = vpadd_u8(lena0, lena0);
+		uint8x8_t const lenb1 = vpadd_u8(lena1, lena1);
+
+		len0 = vget_lane_u8(lenb0, 0);
+		len1 = vget_lane_u8(lenb0, 1);
+		len2 = vget_lane_u8(lenb0, 2);
+		len3 = vget_lane_u8(lenb0, 3);
+		len4 = vget_lane_u8(lenb1, 0);
+		len5 = vget_lane_u8(lenb1, 1);
+		len6 = vget_lane_u8(lenb1, 2);
+		len7 = vget_lane_u8(lenb1, 3);
+	}
+
+	// OR the mask of all blanks with the original index of the vector
+	uint8x16_t const risen0 = vorrq_u8(bmask0, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
+	uint8x16_t const risen1 = vorrq_u8(bmask1, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
+
+	// now just sort that 'risen' to get the desired index of all non-blanks in the front, and all blanks in the back;
+	// an observation: we don't need to sort the entire risen index as a whole, we can sort it piece-wise
+
+	// 4-element sorting network: http://pages.ripco.net/~jgamble/nw.html -- 'Best version', 4 clusters of
+	//
+	//  [[0,1],[2,3]]  [[4,5],[6,7]]  [[8,9],[a,b]]  [[c,d],[e,f]]
+	//  [[0,2],[1,3]]  [[4,6],[5,7]]  [[8,a],[9,b]]  [[c,e],[d,f]]
+	//  [[1,2]]        [[5,6]]        [[9,a]]        [[d,e]]
+	//
+
+	uint8x16_t const st0a = vuzp1q_u8(risen0, risen1);
+	uint8x16_t const st0b = vuzp2q_u8(risen0, risen1);
+	uint8x16_t const st0min = vminq_u8(st0a, st0b); // 0, 2, 4, 6, 8, a, c, e
+	uint8x16_t const st0max = vmaxq_u8(st0a, st0b); // 1, 3, 5, 7, 9, b, d, f
+
+	uint8x16_t const st1a = vtrn1q_u8(st0min, st0max);
+	uint8x16_t const st1b = vtrn2q_u8(st0min, st0max);
+	uint8x16_t const st1min = vminq_u8(st1a, st1b); // 0, 1, 4, 5, 8, 9, c, d
+	uint8x16_t const st1max = vmaxq_u8(st1a, st1b); // 2, 3, 6, 7, a, b, e, f
+
+	uint8x16_t const st2a =            st1min;
+	uint8x16_t const st2b = vrev16q_u8(st1max);
+	uint8x16_t const st2min = vminq_u8(st2a, st2b); // [0], 1, [4], 5, [8], 9, [c], d
+	uint8x16_t const st2max = vmaxq_u8(st2a, st2b); // [3], 2, [7], 6, [b], a, [f], e
+
+	uint16x8_t const stx = vreinterpretq_u16_u8(           st2min );
+	uint16x8_t const sty = vreinterpretq_u16_u8(vrev16q_u8(st2max));
+
+	uint8x16_t const index0 = vreinterpretq_u8_u16(vzip1q_u16(stx, sty));
+	uint8x16_t const index1 = vreinterpretq_u8_u16(vzip2q_u16(stx, sty));
+
+	uint8x16_t const res0 = vqtbl1q_u8(vin0, index0);
+	uint8x16_t const res1 = vqtbl1q_u8(vin1, index1);
+
+	// note: following len cascade is a prime candidate for implementation via prefix sum, but so far the scalar additions pipeline well
+	*reinterpret_cast< uint32_t* >(output)                                                  = vgetq_lane_u32(vreinterpretq_u32_u8(res0), 0);
+	*reinterpret_cast< uint32_t* >(output + len0)                                           = vgetq_lane_u32(vreinterpretq_u32_u8(res0), 1);
+	*reinterpret_cast< uint32_t* >(output + len0 + len1)                                    = vgetq_lane_u32(vreinterpretq_u32_u8(res0), 2);
+	*reinterpret_cast< uint32_t* >(output + len0 + len1 + len2)                             = vgetq_lane_u32(vreinterpretq_u32_u8(res0), 3);
+
+	*reinterpret_cast< uint32_t* >(output + len0 + len1 + len2 + len3)                      = vgetq_lane_u32(vreinterpretq_u32_u8(res1), 0);
+	*reinterpret_cast< uint32_t* >(output + len0 + len1 + len2 + len3 + len4)               = vgetq_lane_u32(vreinterpretq_u32_u8(res1), 1);
+	*reinterpret_cast< uint32_t* >(output + len0 + len1 + len2 + len3 + len4 + len5)        = vgetq_lane_u32(vreinterpretq_u32_u8(res1), 2);
+	*reinterpret_cast< uint32_t* >(output + len0 + len1 + len2 + len3 + len4 + len5 + len6) = vgetq_lane_u32(vreinterpretq_u32_u8(res1), 3);
+
+	return len0 + len1 + len2 + len3 + len4 + len5 + len6 + len7;
+}
+
+// pruner proper, 32-batch; wider version of testee06
+template < bool same_latency_q_and_d = SAME_LATENCY_Q_AND_D, class blank = blank_threshold<> >
+inline size_t testee07(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	uint8x16_t const vin0 = vld1q_u8(input);
+	uint8x16_t const vin1 = vld1q_u8(input + sizeof(uint8x16_t));
+	return testee07_compact< same_latency_q_and_d >(vin0, vin1, blank::mask(vin0), blank::mask(vin1), output);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+// scatter-enabled version of testee01, 64-batch on sve512
+inline size_t testee08(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	svbool_t const pr = svptrue_pat_b8(SV_VL64); // assumed at least sve512
+
+	svuint8_t const vinput = svld1_u8(pr, input);
+	svbool_t const pr_keep = svcmpgt_n_u8(pr, vinput, ' ');
+	size_t const kept = svcntp_b8(pr_keep, pr_keep);
+
+	// prefix sum of to-keep mask
+	svuint8_t prfsum = svdup_n_u8_z(pr_keep, 1);
+	prfsum = svadd_u8_x(pr, prfsum, svext_u8(svdup_n_u8(0), prfsum, 64 -  1)); // assumed exactly sve512
+	prfsum = svadd_u8_x(pr, prfsum, svext_u8(svdup_n_u8(0), prfsum, 64 -  2)); // TODO: possible to use with VLEN?
+	prfsum = svadd_u8_x(pr, prfsum, svext_u8(svdup_n_u8(0), prfsum, 64 -  4));
+	prfsum = svadd_u8_x(pr, prfsum, svext_u8(svdup_n_u8(0), prfsum, 64 -  8));
+	prfsum = svadd_u8_x(pr, prfsum, svext_u8(svdup_n_u8(0), prfsum, 64 - 16));
+	prfsum = svadd_u8_x(pr, prfsum, svext_u8(svdup_n_u8(0), prfsum, 64 - 32));
+	prfsum = svsub_u8_x(pr, prfsum, svdup_n_u8(1)); // 0-based prefix sum
+
+	// 8-bit pred -> 32-bit pred
+	svbool_t const pr_keep0 = svunpklo_b(svunpklo_b(pr_keep)); // - - - +
+	svbool_t const pr_keep1 = svunpkhi_b(svunpklo_b(pr_keep)); // - - + -
+	svbool_t const pr_keep2 = svunpklo_b(svunpkhi_b(pr_keep)); // - + - -
+	svbool_t const pr_keep3 = svunpkhi_b(svunpkhi_b(pr_keep)); // + - - -
+
+	// 8-bit chars -> 32-bit chars
+	svuint32_t const winput0 = svunpklo_u32(svunpklo_u16(vinput));
+	svuint32_t const winput1 = svunpkhi_u32(svunpklo_u16(vinput));
+	svuint32_t const winput2 = svunpklo_u32(svunpkhi_u16(vinput));
+	svuint32_t const winput3 = svunpkhi_u32(svunpkhi_u16(vinput));
+
+	// 8-bit offsets -> 32-bit offsets
+	svuint32_t const woffset0 = svunpklo_u32(svunpklo_u16(prfsum));
+	svuint32_t const woffset1 = svunpkhi_u32(svunpklo_u16(prfsum));
+	svuint32_t const woffset2 = svunpklo_u32(svunpkhi_u16(prfsum));
+	svuint32_t const woffset3 = svunpkhi_u32(svunpkhi_u16(prfsum));
+
+	if (svptest_any(pr_keep0, pr_keep0))
+		svst1b_scatter_offset(pr_keep0, output, woffset0, winput0);
+
+	if (svptest_any(pr_keep1, pr_keep1))
+		svst1b_scatter_offset(pr_keep1, output, woffset1, winput1);
+
+	if (svptest_any(pr_keep2, pr_keep2))
+		svst1b_scatter_offset(pr_keep2, output, woffset2, winput2);
+
+	if (svptest_any(pr_keep3, pr_keep3))
+		svst1b_scatter_offset(pr_keep3, output, woffset3, winput3);
+
+	return kept;
+}
+
+#endif
+#elif __x86_64__ || __i386__
+// compaction of testee04: the non-blanks of vin as per bmask, to output
+PRUNER_TARGET_SSSE3 inline size_t testee04_compact(
+	__m128i const vin,
+	__m128i const bmask,
+	uint8_t* const output) {
+	// OR the mask of all blanks with the original index of the vector
+	__m128i const risen = _mm_or_si128(bmask, _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+
+	// now just sort that 'risen' to get the desired index of all non-blanks in the front, and all blanks in the back;
+	// an observation: we don't need to sort the entire risen index as a whole, we can sort it piece-wise
+
+	// 4-element sorting network: http://pages.ripco.net/~jgamble/nw.html -- 'Best version', 4 clusters of
+	//
+	//  [[0,1],[2,3]]  [[4,5],[6,7]]  [[8,9],[a,b]]  [[c,d],[e,f]]
+	//  [[0,2],[1,3]]  [[4,6],[5,7]]  [[8,a],[9,b]]  [[c,e],[d,f]]
+	//  [[1,2]]        [[5,6]]        [[9,a]]        [[d,e]]
+	//
+
+	__m128i const st0a = _mm_shuffle_epi8(risen, _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st0b = _mm_shuffle_epi8(risen, _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st0min = _mm_min_epu8(st0a, st0b); // 0, 2, 4, 6, 8, a, c, e
+	__m128i const st0max = _mm_max_epu8(st0a, st0b); // 1, 3, 5, 7, 9, b, d, f
+
+	__m128i const st0 = _mm_unpacklo_epi64(st0min, st0max);
+	__m128i const st1a = _mm_shuffle_epi8(st0, _mm_setr_epi8(0, 8, 2, 10, 4, 12, 6, 14, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st1b = _mm_shuffle_epi8(st0, _mm_setr_epi8(1, 9, 3, 11, 5, 13, 7, 15, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st1min = _mm_min_epu8(st1a, st1b); // 0, 1, 4, 5, 8, 9, c, d
+	__m128i const st1max = _mm_max_epu8(st1a, st1b); // 2, 3, 6, 7, a, b, e, f
+
+	__m128i const st2a =                  st1min;
+	__m128i const st2b = _mm_shuffle_epi8(st1max, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st2min = _mm_min_epu8(st2a, st2b); // [0], 1, [4], 5, [8], 9, [c], d
+	__m128i const st2max = _mm_max_epu8(st2a, st2b); // [3], 2, [7], 6, [b], a, [f], e
+
+	__m128i const st2 = _mm_unpacklo_epi64(st2min, st2max);
+	__m128i const index = _mm_shuffle_epi8(st2, _mm_setr_epi8(0, 1, 9, 8, 2, 3, 11, 10, 4, 5, 13, 12, 6, 7, 15, 14));
+
+	__m128i const res0 = _mm_shuffle_epi8(vin, index);
+	__m128i const res1 = _mm_shuffle_epi32(res0, 0x55);
+	__m128i const res2 = _mm_shuffle_epi32(res0, 0xee);
+	__m128i const res3 = _mm_shuffle_epi32(res0, 0xff);
+
+	uint32_t const bitmask = ~_mm_movemask_epi8(bmask);
+	uint32_t const len0 = _mm_popcnt_u32(bitmask & 0x00f);
+	uint32_t const len1 = _mm_popcnt_u32(bitmask & 0x0ff);
+	uint32_t const len2 = _mm_popcnt_u32(bitmask & 0xfff);
+
+	*reinterpret_cast< uint32_t* >(output)        = _mm_cvtsi128_si32(res0);
+	*reinterpret_cast< uint32_t* >(output + len0) = _mm_cvtsi128_si32(res1);
+	*reinterpret_cast< uint32_t* >(output + len1) = _mm_cvtsi128_si32(res2);
+	*reinterpret_cast< uint32_t* >(output + len2) = _mm_cvtsi128_si32(res3);
+	return _mm_popcnt_u32(bitmask & 0xffff);
+}
+
+// pruner proper, 16-batch; amd64 cannot properly recreate arm64's testee04, so get creative
+template < class blank = blank_threshold<> >
+PRUNER_TARGET_SSSE3 inline size_t testee04(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	__m128i const vin = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input));
+	return testee04_compact(vin, blank::mask(vin), output);
+}
+
+// pruner proper, 16-batch
+template < class blank = blank_threshold<> >
+PRUNER_TARGET_SSSE3 inline size_t testee05(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	__m128i const vin = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input));
+	__m128i const bmask = blank::mask(vin);
+
+	// OR the mask of all blanks with the original index of the vector
+	__m128i const risen = _mm_or_si128(bmask, _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+
+	// now just sort that 'risen' to get the desired index of all non-blanks in the front, and all blanks in the back
+
+	// 16-element sorting network: http://pages.ripco.net/~jgamble/nw.html -- 'Best version'
+	// stage 0
+	__m128i const st0a = _mm_shuffle_epi8(risen, _mm_setr_epi8( 0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st0b = _mm_shuffle_epi8(risen, _mm_setr_epi8( 1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st0min = _mm_min_epu8(st0a, st0b); //  0, 2, 4, 6, 8, 10, 12, 14
+	__m128i const st0max = _mm_max_epu8(st0a, st0b); //  1, 3, 5, 7, 9, 11, 13, 15
+
+	// stage 1
+	__m128i const st0 = _mm_unpacklo_epi64(st0min, st0max);
+	__m128i const st1a = _mm_shuffle_epi8(st0, _mm_setr_epi8( 0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st1b = _mm_shuffle_epi8(st0, _mm_setr_epi8( 1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st1min = _mm_min_epu8(st1a, st1b); //  0, 4,  8, 12, 1, 5,  9, 13
+	__m128i const st1max = _mm_max_epu8(st1a, st1b); //  2, 6, 10, 14, 3, 7, 11, 15
+
+	// stage 2
+	__m128i const st1 = _mm_unpacklo_epi64(st1min, st1max);
+	__m128i const st2a = _mm_shuffle_epi8(st1, _mm_setr_epi8( 0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st2b = _mm_shuffle_epi8(st1, _mm_setr_epi8( 1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st2min = _mm_min_epu8(st2a, st2b); //  0,  8, 1,  9, 2, 10, 3, 11
+	__m128i const st2max = _mm_max_epu8(st2a, st2b); //  4, 12, 5, 13, 6, 14, 7, 15
+
+	// stage 3
+	__m128i const st2 = _mm_unpacklo_epi64(st2min, st2max);
+	__m128i const st3a = _mm_shuffle_epi8(st2, _mm_setr_epi8( 0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st3b = _mm_shuffle_epi8(st2, _mm_setr_epi8( 1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st3min = _mm_min_epu8(st3a, st3b); // 0, 1,  2,  3,  4,  5,  6,  7
+	__m128i const st3max = _mm_max_epu8(st3a, st3b); // 8, 9, 10, 11, 12, 13, 14, 15
+
+	// from here on some indices are already done -- freeze them, by keeping them in deterministic positions
+
+	// stage 4; indices done so far: 0, 15
+	__m128i const st3 = _mm_unpacklo_epi64(st3min, st3max);
+	__m128i const st4a = _mm_shuffle_epi8(st3, _mm_setr_epi8( 0,  5, 6,  3, 13,  7, 1, 4, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st4b = _mm_shuffle_epi8(st3, _mm_setr_epi8(15, 10, 9, 12, 14, 11, 2, 8, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st4min = _mm_min_epu8(st4a, st4b); // [ 0],  5,  6,  3, 13,  7,  1,  4
+	__m128i const st4max = _mm_max_epu8(st4a, st4b); // [15], 10,  9, 12, 14, 11,  2,  8
+
+	// stage 5; done so far: 0, 15; temp frozen: 3, 12
+	__m128i const st4 = _mm_unpacklo_epi64(st4min, st4max);
+	__m128i const st5a = _mm_shuffle_epi8(st4, _mm_setr_epi8( 0,  3, 6, 5, 14, 13, 1, 10, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st5b = _mm_shuffle_epi8(st4, _mm_setr_epi8( 8, 11, 7, 4, 15, 12, 2,  9, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st5min = _mm_min_epu8(st5a, st5b); // [ 0], [ 3], 1,  7,  2, 11, 5,  9
+	__m128i const st5max = _mm_max_epu8(st5a, st5b); // [15], [12], 4, 13,  8, 14, 6, 10
+
+	// stage 6; done so far: 0, 1, 14, 15; temp frozen: 5, 6, 9, 10
+	__m128i const st5 = _mm_unpacklo_epi64(st5min, st5max);
+	__m128i const st6a = _mm_shuffle_epi8(st5, _mm_setr_epi8( 0,  2,  4,  5,  1, 3,  6,  7, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st6b = _mm_shuffle_epi8(st5, _mm_setr_epi8( 8, 13, 10, 11, 12, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st6min = _mm_min_epu8(st6a, st6b); // [ 0], [ 1], 2, 11,  3,  7, [5], [ 9]
+	__m128i const st6max = _mm_max_epu8(st6a, st6b); // [15], [14], 4, 13,  8, 12, [6], [10]
+
+	// stage 7; done so far: 0, 1, 2, 13, 14, 15; temp frozen: 4, 11
+	__m128i const st6 = _mm_unpacklo_epi64(st6min, st6max);
+	__m128i const st7a = _mm_shuffle_epi8(st6, _mm_setr_epi8( 0, 1,  2,  3, 14, 15, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st7b = _mm_shuffle_epi8(st6, _mm_setr_epi8( 8, 9, 10, 11, 12, 13, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st7min = _mm_min_epu8(st7a, st7b); // [ 0], [ 1], [2], [11],  6, 10, 3, 7
+	__m128i const st7max = _mm_max_epu8(st7a, st7b); // [15], [14], [4], [13],  8, 12, 5, 9
+
+	// stage 8; done so far: 0, 1, 2, 13, 14, 15
+	__m128i const st7 = _mm_unpacklo_epi64(st7min, st7max);
+	__m128i const st8a = _mm_shuffle_epi8(st7, _mm_setr_epi8( 0, 1,  2,  6, 14,  7, 15,  3, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st8b = _mm_shuffle_epi8(st7, _mm_setr_epi8( 8, 9, 11, 10,  4, 12,  5, 13, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st8min = _mm_min_epu8(st8a, st8b); // [ 0], [ 1], [ 2],  3,  5,  7,  9, 11
+	__m128i const st8max = _mm_max_epu8(st8a, st8b); // [15], [14], [13],  4,  6,  8, 10, 12
+
+	// stage 9; done so far: 0, 1, 2, 3, 4, 5, 10, 11, 12, 13, 14, 15
+	__m128i const st8 = _mm_unpacklo_epi64(st8min, st8max);
+	__m128i const st9a = _mm_shuffle_epi8(st8, _mm_setr_epi8( 0, 1,  2,  3, 11,  4, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st9b = _mm_shuffle_epi8(st8, _mm_setr_epi8( 8, 9, 10, 15,  7, 14,  5,  6, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m128i const st9min = _mm_min_epu8(st9a, st9b); // [ 0], [ 1], [ 2], [ 3], [ 4], [ 5],  6,  8
+	__m128i const st9max = _mm_max_epu8(st9a, st9b); // [15], [14], [13], [12], [11], [10],  7,  9
+
+	__m128i const st9 = _mm_unpacklo_epi64(st9min, st9max);
+	__m128i const index = _mm_shuffle_epi8(st9, _mm_setr_epi8( 0, 1, 2, 3, 4, 5, 6, 14, 7, 15, 13, 12, 11, 10, 9, 8 ));
+
+	__m128i const res = _mm_shuffle_epi8(vin, index);
+	_mm_storeu_si128(reinterpret_cast< __m128i* >(output), res);
+	return sizeof(__m128i) - _mm_popcnt_u32(_mm_movemask_epi8(bmask));
+}
+
+// compaction of testee09: the non-blanks of vin as per bmask, to output
+PRUNER_TARGET_AVX2 inline size_t testee09_compact(
+	__m256i const vin,
+	__m256i const bmask,
+	uint8_t* const output) {
+	// OR the mask of all blanks with the original index of each 128-bit lane
+	__m256i const risen = _mm256_or_si256(bmask, _mm256_setr_epi8(
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+
+	// now just sort that 'risen' to get the desired index of all non-blanks in the front, and all blanks in the back;
+	// an observation: we don't need to sort the entire risen index as a whole, we can sort it piece-wise
+
+	// 4-element sorting network: http://pages.ripco.net/~jgamble/nw.html -- 'Best version', 4 clusters of
+	//
+	//  [[0,1],[2,3]]  [[4,5],[6,7]]  [[8,9],[a,b]]  [[c,d],[e,f]]
+	//  [[0,2],[1,3]]  [[4,6],[5,7]]  [[8,a],[9,b]]  [[c,e],[d,f]]
+	//  [[1,2]]        [[5,6]]        [[9,a]]        [[d,e]]
+	//
+	// per each 128-bit lane
+
+	__m256i const st0a = _mm256_shuffle_epi8(risen, _mm256_setr_epi8(
+		0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1,
+		0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m256i const st0b = _mm256_shuffle_epi8(risen, _mm256_setr_epi8(
+		1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1,
+		1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m256i const st0min = _mm256_min_epu8(st0a, st0b); // 0, 2, 4, 6, 8, a, c, e
+	__m256i const st0max = _mm256_max_epu8(st0a, st0b); // 1, 3, 5, 7, 9, b, d, f
+
+	__m256i const st0 = _mm256_unpacklo_epi64(st0min, st0max);
+	__m256i const st1a = _mm256_shuffle_epi8(st0, _mm256_setr_epi8(
+		0, 8, 2, 10, 4, 12, 6, 14, -1, -1, -1, -1, -1, -1, -1, -1,
+		0, 8, 2, 10, 4, 12, 6, 14, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m256i const st1b = _mm256_shuffle_epi8(st0, _mm256_setr_epi8(
+		1, 9, 3, 11, 5, 13, 7, 15, -1, -1, -1, -1, -1, -1, -1, -1,
+		1, 9, 3, 11, 5, 13, 7, 15, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m256i const st1min = _mm256_min_epu8(st1a, st1b); // 0, 1, 4, 5, 8, 9, c, d
+	__m256i const st1max = _mm256_max_epu8(st1a, st1b); // 2, 3, 6, 7, a, b, e, f
+
+	__m256i const st2a =                     st1min;
+	__m256i const st2b = _mm256_shuffle_epi8(st1max, _mm256_setr_epi8(
+		1, 0, 3, 2, 5, 4, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1,
+		1, 0, 3, 2, 5, 4, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1));
+	__m256i const st2min = _mm256_min_epu8(st2a, st2b); // [0], 1, [4], 5, [8], 9, [c], d
+	__m256i const st2max = _mm256_max_epu8(st2a, st2b); // [3], 2, [7], 6, [b], a, [f], e
+
+	__m256i const st2 = _mm256_unpacklo_epi64(st2min, st2max);
+	__m256i const index = _mm256_shuffle_epi8(st2, _mm256_setr_epi8(
+		0, 1, 9, 8, 2, 3, 11, 10, 4, 5, 13, 12, 6, 7, 15, 14,
+		0, 1, 9, 8, 2, 3, 11, 10, 4, 5, 13, 12, 6, 7, 15, 14));
+
+	__m256i const res = _mm256_shuffle_epi8(vin, index);
+	__m128i const res0 = _mm256_castsi256_si128(res);
+	__m128i const res1 = _mm_shuffle_epi32(res0, 0x55);
+	__m128i const res2 = _mm_shuffle_epi32(res0, 0xee);
+	__m128i const res3 = _mm_shuffle_epi32(res0, 0xff);
+	__m128i const res4 = _mm256_extracti128_si256(res, 1);
+	__m128i const res5 = _mm_shuffle_epi32(res4, 0x55);
+	__m128i const res6 = _mm_shuffle_epi32(res4, 0xee);
+	__m128i const res7 = _mm_shuffle_epi32(res4, 0xff);
+
+	uint32_t const bitmask = ~_mm256_movemask_epi8(bmask);
+	uint32_t const len0 = _mm_popcnt_u32(bitmask & 0x0000000f);
+	uint32_t const len1 = _mm_popcnt_u32(bitmask & 0x000000ff);
+	uint32_t const len2 = _mm_popcnt_u32(bitmask & 0x00000fff);
+	uint32_t const len3 = _mm_popcnt_u32(bitmask & 0x0000ffff);
+	uint32_t const len4 = _mm_popcnt_u32(bitmask & 0x000fffff);
+	uint32_t const len5 = _mm_popcnt_u32(bitmask & 0x00ffffff);
+	uint32_t const len6 = _mm_popcnt_u32(bitmask & 0x0fffffff);
+
+	*reinterpret_cast< uint32_t* >(output)        = _mm_cvtsi128_si32(res0);
+	*reinterpret_cast< uint32_t* >(output + len0) = _mm_cvtsi128_si32(res1);
+	*reinterpret_cast< uint32_t* >(output + len1) = _mm_cvtsi128_si32(res2);
+	*reinterpret_cast< uint32_t* >(output + len2) = _mm_cvtsi128_si32(res3);
+	*reinterpret_cast< uint32_t* >(output + len3) = _mm_cvtsi128_si32(res4);
+	*reinterpret_cast< uint32_t* >(output + len4) = _mm_cvtsi128_si32(res5);
+	*reinterpret_cast< uint32_t* >(output + len5) = _mm_cvtsi128_si32(res6);
+	*reinterpret_cast< uint32_t* >(output + len6) = _mm_cvtsi128_si32(res7);
+	return _mm_popcnt_u32(bitmask);
+}
+
+// pruner proper, 32-batch; AVX2 version of testee04 -- both 128-bit lanes sort their own index, as with testee07/arm64
+template < class blank = blank_threshold<> >
+PRUNER_TARGET_AVX2 inline size_t testee09(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	__m256i const vin = _mm256_loadu_si256(reinterpret_cast< __m256i const* >(input));
+	return testee09_compact(vin, blank::mask(vin), output);
+}
+
+// pruner proper, 64-batch; AVX-512 VBMI2 counterpart of testee08/sve512 -- the byte compress does in one op what the
+// prefix sum and the scatters do there. Compress to a register and store the entire batch: the compress-to-memory
+// form of the op is microcoded on zen4
+template < class blank = blank_threshold<> >
+PRUNER_TARGET_AVX512VBMI2 inline size_t testee10(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	__m512i const vin = _mm512_loadu_si512(input);
+	__mmask64 const keep = blank::keep(vin);
+
+	_mm512_storeu_si512(output, _mm512_maskz_compress_epi8(keep, vin));
+	return __builtin_popcountll(keep);
+}
+
+#endif
+
+// Sorting networks, generated: the pruners proper above sort their risen index by networks scheduled by hand, the
+// ones below by any network given as a type -- 'wires' wires in 'layers' layers of disjoint comparators, where
+// partner(layer, wire) is the wire the given one gets compared with, or itself, and the lesser wire of a pair takes
+// the min. Each layer takes a shuffle, a min and two XORs regardless of its count of comparators: the wires keep their
+// lanes, each lane gets its partner by the shuffle, and the upper wire of each pair gets the max as the min of the
+// complements -- the lanes of the upper wires stay complemented from the XOR going into a layer to the one going out,
+// and the pair of XORs between two layers fold into one.
+
+// log2 of a power of two
+constexpr size_t network_log2(
+	size_t const n) {
+
+	return n > 1 ? 1 + network_log2(n / 2) : 0;
+}
+
+// the layers of Batcher's networks come in merges of growing size, each of them in steps of shrinking distance:
+// merge 0 takes 1 step, merge 1 takes 2, and so on -- the merge of a layer, and the step within it, counted down
+constexpr size_t network_merge(
+	size_t const layer,
+	size_t const merge = 0) {
+
+	return layer <= merge ? merge : network_merge(layer - merge - 1, merge + 1);
+}
+
+constexpr size_t network_step(
+	size_t const layer,
+	size_t const merge = 0) {
+
+	return layer <= merge ? merge - layer : network_step(layer - merge - 1, merge + 1);
+}
+
+// Batcher's bitonic sort, with all comparators ascending: the first step of each merge compares the mirror wires of
+// each block, the rest compare wires at halving distances
+template < size_t n >
+struct network_bitonic {
+	static constexpr size_t wires = n;
+	static constexpr size_t layers = network_log2(n) * (network_log2(n) + 1) / 2;
+
+	static constexpr size_t partner(
+		size_t const layer,
+		size_t const wire) {
+
+		return network_step(layer) == network_merge(layer) ?
+			wire ^ ((size_t(2) << network_merge(layer)) - 1) :
+			wire ^ (size_t(1) << network_step(layer));
+	}
+};
+
+// Batcher's odd-even merge sort; merges of blocks of p wires, at distances k
+template < size_t n >
+struct network_batcher {
+	static constexpr size_t wires = n;
+	static constexpr size_t layers = network_log2(n) * (network_log2(n) + 1) / 2;
+
+	static constexpr bool lower(
+		size_t const p,
+		size_t const k,
+		size_t const wire) {
+
+		return wire >= k % p && (wire - k % p) % (2 * k) < k && wire + k < n && wire / (2 * p) == (wire + k) / (2 * p);
+	}
+
+	static constexpr size_t partner(
+		size_t const layer,
+		size_t const wire) {
+
+		return
+			lower(size_t(1) << network_merge(layer), size_t(1) << network_step(layer), wire) ?
+				wire + (size_t(1) << network_step(layer)) :
+			wire >= (size_t(1) << network_step(layer)) &&
+			lower(size_t(1) << network_merge(layer), size_t(1) << network_step(layer), wire - (size_t(1) << network_step(layer))) ?
+				wire - (size_t(1) << network_step(layer)) :
+				wire;
+	}
+};
+
+// the best known 16-wire network, Green's: 60 comparators in 10 layers -- the one testee04/arm64 and testee05 sort by
+struct network_green16 {
+	static constexpr size_t wires = 16;
+	static constexpr size_t layers = 10;
+
+	// the comparators of a layer, as the lower wire of each pair, then the upper; 0xff past the last pair
+	static constexpr uint64_t pairs(
+		size_t const layer) {
+
+		return
+			layer == 0 ? 0x0e0c0a0806040200 :
+			layer == 1 ? 0x0d0905010c080400 :
+			layer == 2 ? 0x0b030a0209010800 :
+			layer == 3 ? 0x0706050403020100 :
+			layer == 4 ? 0xff0401070d030605 :
+			layer == 5 ? 0xffff090b05020701 :
+			layer == 6 ? 0xffffffff07030b02 :
+			layer == 7 ? 0xffffffff07030a06 :
+			layer == 8 ? 0xffffff0b09070503 :
+			             0xffffffffffff0806;
+	}
+
+	static constexpr uint64_t uppers(
+		size_t const layer) {
+
+		return
+			layer == 0 ? 0x0f0d0b0907050301 :
+			layer == 1 ? 0x0f0b07030e0a0602 :
+			layer == 2 ? 0x0f070e060d050c04 :
+			layer == 3 ? 0x0f0e0d0c0b0a0908 :
+			layer == 4 ? 0xff08020b0e0c090a :
+			layer == 5 ? 0xffff0a0e06080d04 :
+			layer == 6 ? 0xffffffff0c080d04 :
+			layer == 7 ? 0xffffffff09050c08 :
+			layer == 8 ? 0xffffff0c0a080604 :
+			             0xffffffffffff0907;
+	}
+
+	static constexpr size_t partner(
+		size_t const layer,
+		size_t const wire,
+		size_t const pair = 0) {
+
+		return pair == 8 ? wire :
+			(pairs(layer) >> pair * 8 & 0xff) == wire ? uppers(layer) >> pair * 8 & 0xff :
+			(uppers(layer) >> pair * 8 & 0xff) == wire ? pairs(layer) >> pair * 8 & 0xff :
+			partner(layer, wire, pair + 1);
+	}
+};
+
+// the constants of the layers of a network, 8 lanes to a word, little-endian; lanes past the wires repeat the network,
+// for the shuffles within 128-bit lanes
+template < class network >
+struct network_words {
+	static constexpr bool upper(
+		size_t const layer,
+		size_t const wire) {
+
+		return layer < network::layers && network::partner(layer, wire) < wire;
+	}
+
+	// the shuffle of a layer: the partner of each wire
+	static constexpr uint64_t shuffle(
+		size_t const layer,
+		size_t const word,
+		size_t const k = 0) {
+
+		return k == 8 ? 0 :
+			uint64_t(network::partner(layer, (word * 8 + k) % network::wires)) << k * 8 | shuffle(layer, word, k + 1);
+	}
+
+	// complement of the partners fetched: all wires of a pair, as the complemented lanes of the pair differ
+	static constexpr uint64_t paired(
+		size_t const layer,
+		size_t const word,
+		size_t const k = 0) {
+
+		return k == 8 ? 0 :
+			(network::partner(layer, (word * 8 + k) % network::wires) != (word * 8 + k) % network::wires ?
+				uint64_t(0xff) << k * 8 : 0) | paired(layer, word, k + 1);
+	}
+
+	// complement of the lanes going into a layer: the upper wires of the previous layer, and those of this layer
+	static constexpr uint64_t flip(
+		size_t const layer,
+		size_t const word,
+		size_t const k = 0) {
+
+		return k == 8 ? 0 :
+			((layer > 0 && upper(layer - 1, (word * 8 + k) % network::wires)) !=
+				upper(layer, (word * 8 + k) % network::wires) ? uint64_t(0xff) << k * 8 : 0) | flip(layer, word, k + 1);
+	}
+};
+
+#if __aarch64__
+// sort of the 16 lanes of a vector by a 16-wire network
+template < class network, size_t layer = 0 >
+inline uint8x16_t network_sort(
+	uint8x16_t const t,
+	std::true_type) {
+
+	typedef network_words< network > words;
+	return veorq_u8(t, vcombine_u8(vcreate_u8(words::flip(layer, 0)), vcreate_u8(words::flip(layer, 1))));
+}
+
+template < class network, size_t layer = 0 >
+inline uint8x16_t network_sort(
+	uint8x16_t const v,
+	std::false_type = std::false_type()) {
+
+	typedef network_words< network > words;
+	uint8x16_t const t = veorq_u8(v, vcombine_u8(vcreate_u8(words::flip(layer, 0)), vcreate_u8(words::flip(layer, 1))));
+	uint8x16_t const q = veorq_u8(
+		vqtbl1q_u8(t, vcombine_u8(vcreate_u8(words::shuffle(layer, 0)), vcreate_u8(words::shuffle(layer, 1)))),
+		vcombine_u8(vcreate_u8(words::paired(layer, 0)), vcreate_u8(words::paired(layer, 1))));
+
+	return network_sort< network, layer + 1 >(vminq_u8(t, q), std::integral_constant< bool, layer + 1 == network::layers >());
+}
+
+// pruner proper, 16-batch; sorts the risen index by a generated network
+template < class network = network_green16, class blank = blank_threshold<> >
+inline size_t testee11(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	static_assert(network::wires == 16, "testee11 sorts 16 lanes");
+
+	uint8x16_t const vin = vld1q_u8(input);
+	uint8x16_t const bmask = blank::mask(vin);
+	uint8x16_t const risen = vorrq_u8(bmask, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
+	uint8x16_t const index = network_sort< network >(risen);
+
+	vst1q_u8(output, vqtbl1q_u8(vin, index));
+	return sizeof(uint8x16_t) + int8_t(vaddvq_u8(bmask));
+}
+
+#elif __x86_64__ || __i386__
+// sort of the 16 lanes of a vector by a 16-wire network
+template < class network, size_t layer = 0 >
+PRUNER_TARGET_SSSE3 inline __m128i network_sort(
+	__m128i const t,
+	std::true_type) {
+
+	typedef network_words< network > words;
+	return _mm_xor_si128(t, _mm_set_epi64x(words::flip(layer, 1), words::flip(layer, 0)));
+}
+
+template < class network, size_t layer = 0 >
+PRUNER_TARGET_SSSE3 inline __m128i network_sort(
+	__m128i const v,
+	std::false_type = std::false_type()) {
+
+	typedef network_words< network > words;
+	__m128i const t = _mm_xor_si128(v, _mm_set_epi64x(words::flip(layer, 1), words::flip(layer, 0)));
+	__m128i const q = _mm_xor_si128(
+		_mm_shuffle_epi8(t, _mm_set_epi64x(words::shuffle(layer, 1), words::shuffle(layer, 0))),
+		_mm_set_epi64x(words::paired(layer, 1), words::paired(layer, 0)));
+
+	return network_sort< network, layer + 1 >(_mm_min_epu8(t, q), std::integral_constant< bool, layer + 1 == network::layers >());
+}
+
+// sort of each 128-bit lane of a vector by a 16-wire network
+template < class network, size_t layer = 0 >
+PRUNER_TARGET_AVX2 inline __m256i network_sort(
+	__m256i const t,
+	std::true_type) {
+
+	typedef network_words< network > words;
+	return _mm256_xor_si256(t, _mm256_set_epi64x(
+		words::flip(layer, 3), words::flip(layer, 2), words::flip(layer, 1), words::flip(layer, 0)));
+}
+
+template < class network, size_t layer = 0 >
+PRUNER_TARGET_AVX2 inline __m256i network_sort(
+	__m256i const v,
+	std::false_type = std::false_type()) {
+
+	typedef network_words< network > words;
+	__m256i const t = _mm256_xor_si256(v, _mm256_set_epi64x(
+		words::flip(layer, 3), words::flip(layer, 2), words::flip(layer, 1), words::flip(layer, 0)));
+	__m256i const q = _mm256_xor_si256(
+		_mm256_shuffle_epi8(t, _mm256_set_epi64x(
+			words::shuffle(layer, 3), words::shuffle(layer, 2), words::shuffle(layer, 1), words::shuffle(layer, 0))),
+		_mm256_set_epi64x(
+			words::paired(layer, 3), words::paired(layer, 2), words::paired(layer, 1), words::paired(layer, 0)));
+
+	return network_sort< network, layer + 1 >(_mm256_min_epu8(t, q), std::integral_constant< bool, layer + 1 == network::layers >());
+}
+
+// sort of the 64 lanes of a vector by a 64-wire network; the shuffles cross lanes, by VBMI's vpermb, which comes with every VBMI2 part
+template < class network, size_t layer = 0 >
+PRUNER_TARGET_AVX512VBMI2 inline __m512i network_sort(
+	__m512i const t,
+	std::true_type) {
+
+	typedef network_words< network > words;
+	return _mm512_xor_si512(t, _mm512_set_epi64(
+		words::flip(layer, 7), words::flip(layer, 6), words::flip(layer, 5), words::flip(layer, 4),
+		words::flip(layer, 3), words::flip(layer, 2), words::flip(layer, 1), words::flip(layer, 0)));
+}
+
+template < class network, size_t layer = 0 >
+PRUNER_TARGET_AVX512VBMI2 inline __m512i network_sort(
+	__m512i const v,
+	std::false_type = std::false_type()) {
+
+	typedef network_words< network > words;
+	__m512i const t = _mm512_xor_si512(v, _mm512_set_epi64(
+		words::flip(layer, 7), words::flip(layer, 6), words::flip(layer, 5), words::flip(layer, 4),
+		words::flip(layer, 3), words::flip(layer, 2), words::flip(layer, 1), words::flip(layer, 0)));
+	__m512i const q = _mm512_xor_si512(
+		_mm512_maskz_permutexvar_epi8(~__mmask64(0), _mm512_set_epi64(
+			words::shuffle(layer, 7), words::shuffle(layer, 6), words::shuffle(layer, 5), words::shuffle(layer, 4),
+			words::shuffle(layer, 3), words::shuffle(layer, 2), words::shuffle(layer, 1), words::shuffle(layer, 0)), t),
+		_mm512_set_epi64(
+			words::paired(layer, 7), words::paired(layer, 6), words::paired(layer, 5), words::paired(layer, 4),
+			words::paired(layer, 3), words::paired(layer, 2), words::paired(layer, 1), words::paired(layer, 0)));
+
+	return network_sort< network, layer + 1 >(_mm512_min_epu8(t, q), std::integral_constant< bool, layer + 1 == network::layers >());
+}
+
+// pruner proper, 16-batch; sorts the risen index by a generated network
+template < class network = network_green16, class blank = blank_threshold<> >
+PRUNER_TARGET_SSSE3 inline size_t testee11(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	static_assert(network::wires == 16, "testee11 sorts 16 lanes");
+
+	__m128i const vin = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input));
+	__m128i const bmask = blank::mask(vin);
+	__m128i const risen = _mm_or_si128(bmask, _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+	__m128i const index = network_sort< network >(risen);
+
+	_mm_storeu_si128(reinterpret_cast< __m128i* >(output), _mm_shuffle_epi8(vin, index));
+	return sizeof(__m128i) - _mm_popcnt_u32(_mm_movemask_epi8(bmask));
+}
+
+// pruner proper, 32-batch; AVX2 version of testee11, each 128-bit lane sorting its own index
+template < class network = network_green16, class blank = blank_threshold<> >
+PRUNER_TARGET_AVX2 inline size_t testee12(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	static_assert(network::wires == 16, "testee12 sorts 16 lanes, twice");
+
+	__m256i const vin = _mm256_loadu_si256(reinterpret_cast< __m256i const* >(input));
+	__m256i const bmask = blank::mask(vin);
+	__m256i const risen = _mm256_or_si256(bmask, _mm256_setr_epi8(
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+	__m256i const res = _mm256_shuffle_epi8(vin, network_sort< network >(risen));
+
+	uint32_t const bitmask = ~_mm256_movemask_epi8(bmask);
+	uint32_t const len0 = _mm_popcnt_u32(bitmask & 0xffff);
+
+	_mm_storeu_si128(reinterpret_cast< __m128i* >(output), _mm256_castsi256_si128(res));
+	_mm_storeu_si128(reinterpret_cast< __m128i* >(output + len0), _mm256_extracti128_si256(res, 1));
+	return _mm_popcnt_u32(bitmask);
+}
+
+// pruner proper, 64-batch; sorts the risen index of all 64 lanes by a generated network -- a showcase of the
+// generator, rather than a contender of testee10
+template < class network = network_bitonic< 64 >, class blank = blank_threshold<> >
+PRUNER_TARGET_AVX512VBMI2 inline size_t testee13(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	static_assert(network::wires == 64, "testee13 sorts 64 lanes");
+
+	__m512i const vin = _mm512_loadu_si512(input);
+	__mmask64 const keep = blank::keep(vin);
+	__m512i const iota = _mm512_set_epi64(
+		0x3f3e3d3c3b3a3938, 0x3736353433323130, 0x2f2e2d2c2b2a2928, 0x2726252423222120,
+		0x1f1e1d1c1b1a1918, 0x1716151413121110, 0x0f0e0d0c0b0a0908, 0x0706050403020100);
+	__m512i const risen = _mm512_mask_blend_epi8(keep, _mm512_set1_epi8(-1), iota);
+
+	_mm512_storeu_si512(output, _mm512_maskz_permutexvar_epi8(~__mmask64(0), network_sort< network >(risen), vin));
+	return __builtin_popcountll(keep);
+}
+
+#endif
+
+// Lookup-table pruners, after Lemire's: the mask of non-blanks of a chunk of the batch picks the compaction shuffle
+// from a table, in place of any sorting. The table takes 2^bits entries of the kept lanes of each mask, in order, then
+// out-of-range lanes (zeroing ones, for pshufb and tbl alike): 8 bytes an entry for 8-bit masks (2 KiB, two chunks a
+// batch), 16 bytes for 12-bit (64 KiB, a chunk of 12 and one of 4) and for 16-bit (1 MiB, the whole batch at once).
+// The tables get built on first use; past that, the tradeoff is with the cache -- see README.md.
+template < unsigned bits >
+struct prune_lut {
+	static_assert(bits == 8 || bits == 12 || bits == 16, "prune_lut takes 8-, 12- or 16-bit masks");
+
+	static constexpr size_t stride = bits <= 8 ? 8 : 16;
+
+	static void build(uint8_t* const table) {
+		for (size_t mask = 0; mask < size_t(1) << bits; ++mask) {
+			uint8_t* const entry = table + mask * stride;
+			size_t kept = 0;
+
+			for (size_t lane = 0; lane < bits; ++lane)
+				if (mask >> lane & 1)
+					entry[kept++] = lane;
+
+			memset(entry + kept, 0x80, stride - kept);
+		}
+	}
+
+	// thread-safe, as is the initialization of any function-local static
+	static uint8_t const* table() {
+		alignas(64) static uint8_t entries[stride << bits];
+		static bool const built = (build(entries), true);
+
+		(void) built;
+		return entries;
+	}
+};
+
+#if __aarch64__
+// pruner proper, 16-batch; compacts by a table shuffle, per chunks of 'bits' chars
+template < unsigned bits = 16, class blank = blank_threshold<> >
+inline size_t testee14(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	uint8x16_t const vin = vld1q_u8(input);
+	uint8x16_t const bmask = blank::mask(vin);
+
+	// no movemask on arm64: weigh the non-blank lanes by their bit, and sum up either half
+	uint8x16_t const weighed = vbicq_u8(
+		(uint8x16_t) { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 }, bmask);
+	uint32_t const keep = vaddv_u8(vget_low_u8(weighed)) | uint32_t(vaddv_u8(vget_high_u8(weighed))) << 8;
+	uint8_t const* const table = prune_lut< bits >::table();
+
+	if (bits == 16) {
+		vst1q_u8(output, vqtbl1q_u8(vin, vld1q_u8(table + keep * 16)));
+		return __builtin_popcount(keep);
+	}
+
+	if (bits == 12) {
+		uint32_t const len0 = __builtin_popcount(keep & 0xfff);
+		uint8x8_t const index1 = vadd_u8(vld1_u8(table + (keep >> 12) * 16), vdup_n_u8(12));
+		uint32_t const res1 = vget_lane_u32(vreinterpret_u32_u8(vqtbl1_u8(vin, index1)), 0);
+
+		vst1q_u8(output, vqtbl1q_u8(vin, vld1q_u8(table + (keep & 0xfff) * 16)));
+		memcpy(output + len0, &res1, sizeof(res1));
+		return __builtin_popcount(keep);
+	}
+
+	uint32_t const len0 = __builtin_popcount(keep & 0xff);
+	uint8x16_t const index = vcombine_u8(
+		vld1_u8(table + (keep & 0xff) * 8),
+		vadd_u8(vld1_u8(table + (keep >> 8) * 8), vdup_n_u8(8)));
+	uint8x16_t const res = vqtbl1q_u8(vin, index);
+
+	vst1q_u8(output, res);
+	vst1_u8(output + len0, vget_high_u8(res));
+	return __builtin_popcount(keep);
+}
+
+#elif __x86_64__ || __i386__
+// pruner proper, 16-batch; compacts by a table shuffle, per chunks of 'bits' chars
+template < unsigned bits = 16, class blank = blank_threshold<> >
+PRUNER_TARGET_SSSE3 inline size_t testee14(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	__m128i const vin = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input));
+	uint32_t const keep = ~_mm_movemask_epi8(blank::mask(vin)) & 0xffff;
+	uint8_t const* const table = prune_lut< bits >::table();
+
+	if (bits == 16) {
+		__m128i const index = _mm_load_si128(reinterpret_cast< __m128i const* >(table + keep * 16));
+
+		_mm_storeu_si128(reinterpret_cast< __m128i* >(output), _mm_shuffle_epi8(vin, index));
+		return _mm_popcnt_u32(keep);
+	}
+
+	if (bits == 12) {
+		uint32_t const len0 = _mm_popcnt_u32(keep & 0xfff);
+		__m128i const index0 = _mm_load_si128(reinterpret_cast< __m128i const* >(table + (keep & 0xfff) * 16));
+		__m128i const index1 = _mm_add_epi8(
+			_mm_loadl_epi64(reinterpret_cast< __m128i const* >(table + (keep >> 12) * 16)), _mm_set1_epi8(12));
+		uint32_t const res1 = _mm_cvtsi128_si32(_mm_shuffle_epi8(vin, index1));
+
+		_mm_storeu_si128(reinterpret_cast< __m128i* >(output), _mm_shuffle_epi8(vin, index0));
+		memcpy(output + len0, &res1, sizeof(res1));
+		return _mm_popcnt_u32(keep);
+	}
+
+	uint32_t const len0 = _mm_popcnt_u32(keep & 0xff);
+	__m128i const index = _mm_unpacklo_epi64(
+		_mm_loadl_epi64(reinterpret_cast< __m128i const* >(table + (keep & 0xff) * 8)),
+		_mm_add_epi8(_mm_loadl_epi64(reinterpret_cast< __m128i const* >(table + (keep >> 8) * 8)), _mm_set1_epi8(8)));
+	__m128i const res = _mm_shuffle_epi8(vin, index);
+
+	_mm_storeu_si128(reinterpret_cast< __m128i* >(output), res);
+	_mm_storel_epi64(reinterpret_cast< __m128i* >(output + len0), _mm_unpackhi_epi64(res, res));
+	return _mm_popcnt_u32(keep);
+}
+
+#endif
+#if __x86_64__
+// PEXT pruner: a 64-bit pext compacts 8 chars at a time, under the byte mask of the non-blanks straight out of the
+// compare -- no sorting and no shuffles, so none of the pressure on the shuffle port of the pruners above. Each 8 chars
+// of the batch make a chain of their own, of pext and popcnt, tied to the rest by the output position alone. Only for
+// cores with pext in hardware: Intel from Haswell on, AMD from Zen 3 on; Zen 1 and 2 run it in microcode, at a latency
+// of tens of clocks up, depending on the mask.
+
+// pruner proper, 32-batch
+template < class blank = blank_threshold<> >
+PRUNER_TARGET_BMI2 inline size_t testee15(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	__m128i const vin0 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 0);
+	__m128i const vin1 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 1);
+	__m128i const bmask0 = blank::mask(vin0);
+	__m128i const bmask1 = blank::mask(vin1);
+
+	uint64_t const keep0 = ~uint64_t(_mm_cvtsi128_si64(bmask0));
+	uint64_t const keep1 = ~uint64_t(_mm_cvtsi128_si64(_mm_unpackhi_epi64(bmask0, bmask0)));
+	uint64_t const keep2 = ~uint64_t(_mm_cvtsi128_si64(bmask1));
+	uint64_t const keep3 = ~uint64_t(_mm_cvtsi128_si64(_mm_unpackhi_epi64(bmask1, bmask1)));
+
+	uint64_t const res0 = _pext_u64(_mm_cvtsi128_si64(vin0), keep0);
+	uint64_t const res1 = _pext_u64(_mm_cvtsi128_si64(_mm_unpackhi_epi64(vin0, vin0)), keep1);
+	uint64_t const res2 = _pext_u64(_mm_cvtsi128_si64(vin1), keep2);
+	uint64_t const res3 = _pext_u64(_mm_cvtsi128_si64(_mm_unpackhi_epi64(vin1, vin1)), keep3);
+
+	size_t const len0 = _mm_popcnt_u64(keep0) >> 3;
+	size_t const len1 = _mm_popcnt_u64(keep1) >> 3;
+	size_t const len2 = _mm_popcnt_u64(keep2) >> 3;
+	size_t const len3 = _mm_popcnt_u64(keep3) >> 3;
+
+	memcpy(output, &res0, sizeof(res0));
+	memcpy(output + len0, &res1, sizeof(res1));
+	memcpy(output + len0 + len1, &res2, sizeof(res2));
+	memcpy(output + len0 + len1 + len2, &res3, sizeof(res3));
+	return len0 + len1 + len2 + len3;
+}
+
+#endif
+// Prefix-sum pruners, for targets with neither a byte shuffle nor popcnt: the count of blanks ahead of each non-blank
+// within its 8 chars is how far it moves down, and the moves go by the bits of that count, lowest first -- shifts of
+// the 8 chars by 1, 2, then 4, each taking the chars whose count has that bit set. Taken lowest bit first, no two chars
+// ever land in the same lane, and the blanks, zeroed up front, are overwritten or left behind. The shifts stay within
+// 64-bit lanes, off the shuffle port on x86. These know just the default predicate; testee00 stands in for them with
+// the rest.
+#if __x86_64__ || __i386__
+// pruner proper, 16-batch; SSE2 alone, e.g. for hosts with SSSE3 masked off -- testee17 on both halves at once
+PRUNER_TARGET_SSE2 inline size_t testee16(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	__m128i const vin = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input));
+	__m128i const bmask = _mm_cmpeq_epi8(_mm_min_epu8(vin, _mm_set1_epi8(' ')), vin);
+
+	// blanks ahead of each char, within its half
+	__m128i const ones = _mm_and_si128(bmask, _mm_set1_epi8(1));
+	__m128i prfsum = _mm_slli_epi64(ones, 8);
+	prfsum = _mm_add_epi8(prfsum, _mm_slli_epi64(prfsum, 8));
+	prfsum = _mm_add_epi8(prfsum, _mm_slli_epi64(prfsum, 16));
+	prfsum = _mm_add_epi8(prfsum, _mm_slli_epi64(prfsum, 32));
+
+	__m128i const total = _mm_add_epi8(prfsum, ones);
+	size_t const len0 = 8 - (_mm_extract_epi16(total, 3) >> 8);
+	size_t const len1 = 8 - (_mm_extract_epi16(total, 7) >> 8);
+	__m128i res = _mm_andnot_si128(bmask, vin);
+	__m128i dist = _mm_andnot_si128(bmask, prfsum);
+
+#define STEP(n) { \
+	__m128i const move = _mm_cmpeq_epi8(_mm_and_si128(dist, _mm_set1_epi8(n)), _mm_set1_epi8(n)); \
+	__m128i const res_move = _mm_and_si128(res, move); \
+	__m128i const dist_move = _mm_and_si128(dist, move); \
+	res = _mm_or_si128(_mm_xor_si128(res, res_move), _mm_srli_epi64(res_move, n * 8)); \
+	dist = _mm_or_si128(_mm_xor_si128(dist, dist_move), _mm_srli_epi64(dist_move, n * 8)); \
+}
+	STEP(1)
+	STEP(2)
+
+#undef STEP
+	__m128i const move = _mm_cmpeq_epi8(_mm_and_si128(dist, _mm_set1_epi8(4)), _mm_set1_epi8(4));
+	__m128i const res_move = _mm_and_si128(res, move);
+	res = _mm_or_si128(_mm_xor_si128(res, res_move), _mm_srli_epi64(res_move, 32));
+
+	_mm_storel_epi64(reinterpret_cast< __m128i* >(output), res);
+	_mm_storel_epi64(reinterpret_cast< __m128i* >(output + len0), _mm_unpackhi_epi64(res, res));
+	return len0 + len1;
+}
+
+#endif
+// pruner proper, 16-batch; 64-bit SWAR, for any target -- two words of 8 chars, on the integer units alone
+inline size_t testee17_word(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	uint64_t const lsb = 0x0101010101010101;
+	uint64_t const msb = 0x8080808080808080;
+	uint64_t word;
+
+	memcpy(&word, input, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	word = __builtin_bswap64(word);
+#endif
+
+	// a blank is a char below ' ' + 1: no borrow from one char into the next with the msb of each set ahead
+	uint64_t const ones = (~(word | ((word | msb) - lsb * (' ' + 1))) & msb) >> 7;
+	uint64_t const bmask = ones * 0xff;
+
+	// blanks ahead of each char
+	uint64_t prfsum = ones << 8;
+	prfsum += prfsum << 8;
+	prfsum += prfsum << 16;
+	prfsum += prfsum << 32;
+
+	size_t const blanks = (prfsum + ones) >> 56;
+	uint64_t res = word & ~bmask;
+	uint64_t dist = prfsum & ~bmask;
+
+	for (unsigned bit = 0; bit < 3; ++bit) {
+		uint64_t const move = (dist >> bit & lsb) * 0xff;
+		res = (res & ~move) | (res & move) >> (8 << bit);
+		dist = (dist & ~move) | (dist & move) >> (8 << bit);
+	}
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	res = __builtin_bswap64(res);
+#endif
+	memcpy(output, &res, sizeof(res));
+	return 8 - blanks;
+}
+
+inline size_t testee17(
+	uint8_t const* const input,
+	uint8_t* const output) {
+	size_t const len0 = testee17_word(input, output);
+	return len0 + testee17_word(input + 8, output + len0);
+}
+
+
+// Collapse testees: each run of blanks comes out as a single ' ' rather than nothing. 'run' tells whether the char
+// before the batch was a blank, and is left telling whether the last char of the batch was one. Blanks preceded by a
+// blank are dropped, the rest are replaced with ' ', and the result goes through the compaction of the matching
+// pruner proper -- the sole extra work per batch being a shift of the blank mask by one char.
+template < class blank = blank_threshold<> >
+inline size_t collapse00(
+	uint8_t const* const input,
+	uint8_t* const output,
+	bool& run) {
+	size_t i = 0, pos = 0;
+	bool prev = run;
+	while (i < 16) {
+		uint8_t const c = input[i++];
+		bool const b = blank::scalar(c);
+		output[pos] = b ? ' ' : c;
+		pos += (b && prev ? 0 : 1);
+		prev = b;
+	}
+	run = prev;
+	return pos;
+}
+
+#if __aarch64__
+// collapse version of testee07, 32-batch
+template < bool same_latency_q_and_d = SAME_LATENCY_Q_AND_D, class blank = blank_threshold<> >
+inline size_t collapse07(
+	uint8_t const* const input,
+	uint8_t* const output,
+	bool& run) {
+	uint8x16_t const vin0 = vld1q_u8(input);
+	uint8x16_t const vin1 = vld1q_u8(input + sizeof(uint8x16_t));
+	uint8x16_t const bmask0 = blank::mask(vin0);
+	uint8x16_t const bmask1 = blank::mask(vin1);
+
+	// blank mask of the preceding chars
+	uint8x16_t const prev0 = vextq_u8(vdupq_n_u8(run ? 0xff : 0), bmask0, 15);
+	uint8x16_t const prev1 = vextq_u8(bmask0, bmask1, 15);
+	run = vgetq_lane_u8(bmask1, 15) != 0;
+
+	uint8x16_t const space = vdupq_n_u8(' ');
+	return testee07_compact< same_latency_q_and_d >(
+		vbslq_u8(bmask0, space, vin0),
+		vbslq_u8(bmask1, space, vin1),
+		vandq_u8(bmask0, prev0),
+		vandq_u8(bmask1, prev1),
+		output);
+}
+
+#elif __x86_64__ || __i386__
+// collapse version of testee04, 16-batch
+template < class blank = blank_threshold<> >
+PRUNER_TARGET_SSSE3 inline size_t collapse04(
+	uint8_t const* const input,
+	uint8_t* const output,
+	bool& run) {
+	__m128i const vin = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input));
+	__m128i const bmask = blank::mask(vin);
+
+	// blank mask of the preceding chars
+	__m128i const prev = _mm_or_si128(_mm_slli_si128(bmask, 1), _mm_cvtsi32_si128(run ? 0xff : 0));
+	run = _mm_movemask_epi8(bmask) >> 15;
+
+	__m128i const vout = _mm_or_si128(_mm_andnot_si128(bmask, vin), _mm_and_si128(bmask, _mm_set1_epi8(' ')));
+	return testee04_compact(vout, _mm_and_si128(bmask, prev), output);
+}
+
+// collapse version of testee09, 32-batch
+template < class blank = blank_threshold<> >
+PRUNER_TARGET_AVX2 inline size_t collapse09(
+	uint8_t const* const input,
+	uint8_t* const output,
+	bool& run) {
+	__m256i const vin = _mm256_loadu_si256(reinterpret_cast< __m256i const* >(input));
+	__m256i const bmask = blank::mask(vin);
+
+	// blank mask of the preceding chars; the shift by one char crosses the 128-bit lanes through a lane permute
+	__m256i const prev = _mm256_or_si256(
+		_mm256_alignr_epi8(bmask, _mm256_permute2x128_si256(bmask, bmask, 0x08), 15),
+		_mm256_setr_epi32(run ? 0xff : 0, 0, 0, 0, 0, 0, 0, 0));
+	run = uint32_t(_mm256_movemask_epi8(bmask)) >> 31;
+
+	__m256i const vout = _mm256_blendv_epi8(vin, _mm256_set1_epi8(' '), bmask);
+	return testee09_compact(vout, _mm256_and_si256(bmask, prev), output);
+}
+
+// collapse version of testee10, 64-batch
+template < class blank = blank_threshold<> >
+PRUNER_TARGET_AVX512VBMI2 inline size_t collapse10(
+	uint8_t const* const input,
+	uint8_t* const output,
+	bool& run) {
+	__m512i const vin = _mm512_loadu_si512(input);
+	__mmask64 const bmask = ~blank::keep(vin);
+	__mmask64 const keep = ~(bmask & (bmask << 1 | uint64_t(run)));
+	run = bmask >> 63;
+
+	__m512i const vout = _mm512_mask_blend_epi8(bmask, vin, _mm512_set1_epi8(' '));
+	_mm512_storeu_si512(output, _mm512_maskz_compress_epi8(keep, vout));
+	return __builtin_popcountll(keep);
+}
+
+#endif
+
+// Quote-aware testees, for minifying JSON and CSV: blanks within strings are kept. Each consumes a 64-char block, and
+// first gets bitmaps of its blanks, quotes and backslashes; quote_mask() turns the latter two into the mask of the
+// chars within strings, and the blanks outside of that mask go to the compaction of the matching pruner proper.
+
+// state of a quote-aware pruning, carried from block to block, and from call to call
+struct quote_state {
+	uint64_t in_string; // all ones when within a string
+	uint64_t escaped;   // one when the next char is escaped
+};
+
+// Mask of the chars within strings in a 64-char block, given its bitmaps of quotes and backslashes: the opening quote
+// of a string is within, the closing one is not. With escapes (JSON), odd-length runs of backslashes escape the char
+// that follows, as in simdjson's find_escaped_branchless -- the even runs are told from the odd by adding their first
+// odd-position backslashes to all backslashes, and the carry of the add is the escape of the next block. Without
+// escapes (CSV), a doubled quote within a string toggles the state twice, and stays within. The unescaped quotes then
+// go through a prefix XOR.
+template < bool escapes >
+inline uint64_t quote_mask(
+	uint64_t quote,
+	uint64_t bslash,
+	quote_state& state) {
+
+	if (escapes) {
+		uint64_t const even = 0x5555555555555555;
+		bslash &= ~state.escaped;
+
+		uint64_t const follows = bslash << 1 | state.escaped;
+		uint64_t const odd_starts = bslash & ~even & ~follows;
+		uint64_t even_starts;
+		state.escaped = __builtin_add_overflow(odd_starts, bslash, &even_starts);
+
+		quote &= ~((even ^ even_starts << 1) & follows);
+	}
+
+	quote ^= quote << 1;
+	quote ^= quote << 2;
+	quote ^= quote << 4;
+	quote ^= quote << 8;
+	quote ^= quote << 16;
+	quote ^= quote << 32;
+
+	uint64_t const in_string = quote ^ state.in_string;
+	state.in_string = uint64_t(int64_t(in_string) >> 63);
+	return in_string;
+}
+
+// scalar version, over any count of chars; also does the sub-block tails of the vector versions
+template < class blank, bool escapes >
+inline size_t quoted00(
+	uint8_t const* const input,
+	size_t const len,
+	uint8_t* const output,
+	quote_state& state) {
+	size_t pos = 0;
+	bool in_string = state.in_string != 0;
+	bool escaped = state.escaped != 0;
+	for (size_t i = 0; i < len; ++i) {
+		uint8_t const c = input[i];
+		output[pos] = c;
+		pos += (in_string || !blank::scalar(c) ? 1 : 0);
+
+		if (escaped)
+			escaped = false;
+		else if (escapes && c == '\\')
+			escaped = true;
+		else if (c == '"')
+			in_string = !in_string;
+	}
+	state.in_string = in_string ? ~uint64_t(0) : 0;
+	state.escaped = escaped ? 1 : 0;
+	return pos;
+}
+
+#if __aarch64__
+// bitmap of a 64-char block, as per the byte masks of its 16-char quarters
+inline uint64_t bitmap64(
+	uint8x16_t const m0,
+	uint8x16_t const m1,
+	uint8x16_t const m2,
+	uint8x16_t const m3) {
+
+	uint8x16_t const bit = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+	uint8x16_t const sum0 = vpaddq_u8(vandq_u8(m0, bit), vandq_u8(m1, bit));
+	uint8x16_t const sum1 = vpaddq_u8(vandq_u8(m2, bit), vandq_u8(m3, bit));
+	uint8x16_t const sum2 = vpaddq_u8(sum0, sum1);
+	uint8x16_t const sum3 = vpaddq_u8(sum2, sum2);
+	return vgetq_lane_u64(vreinterpretq_u64_u8(sum3), 0);
+}
+
+// byte mask of 16 chars, as per the low 16 bits of a bitmap
+inline uint8x16_t bytemask16(
+	uint64_t const bits) {
+
+	uint8x16_t const bit = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201));
+	return vtstq_u8(vcombine_u8(vdup_n_u8(uint8_t(bits)), vdup_n_u8(uint8_t(bits >> 8))), bit);
+}
+
+// quote-aware version of testee07, 64-batch
+template < bool same_latency_q_and_d, class blank, bool escapes >
+inline size_t quoted07(
+	uint8_t const* const input,
+	uint8_t* const output,
+	quote_state& state) {
+	uint8x16_t const vin0 = vld1q_u8(input);
+	uint8x16_t const vin1 = vld1q_u8(input + sizeof(uint8x16_t) * 1);
+	uint8x16_t const vin2 = vld1q_u8(input + sizeof(uint8x16_t) * 2);
+	uint8x16_t const vin3 = vld1q_u8(input + sizeof(uint8x16_t) * 3);
+
+	uint8x16_t const quote = vdupq_n_u8('"');
+	uint8x16_t const bslash = vdupq_n_u8('\\');
+
+	uint64_t const blanks = bitmap64(blank::mask(vin0), blank::mask(vin1), blank::mask(vin2), blank::mask(vin3));
+	uint64_t const quotes = bitmap64(vceqq_u8(vin0, quote), vceqq_u8(vin1, quote), vceqq_u8(vin2, quote), vceqq_u8(vin3, quote));
+	uint64_t const bslashes = escapes ?
+		bitmap64(vceqq_u8(vin0, bslash), vceqq_u8(vin1, bslash), vceqq_u8(vin2, bslash), vceqq_u8(vin3, bslash)) : 0;
+
+	uint64_t const drop = blanks & ~quote_mask< escapes >(quotes, bslashes, state);
+
+	size_t const len0 = testee07_compact< same_latency_q_and_d >(vin0, vin1, bytemask16(drop), bytemask16(drop >> 16), output);
+	size_t const len1 = testee07_compact< same_latency_q_and_d >(vin2, vin3, bytemask16(drop >> 32), bytemask16(drop >> 48), output + len0);
+	return len0 + len1;
+}
+
+#elif __x86_64__ || __i386__
+// byte mask of 16 chars, as per the low 16 bits of a bitmap
+PRUNER_TARGET_SSSE3 inline __m128i bytemask16(
+	uint64_t const bits) {
+
+	__m128i const bit = _mm_set1_epi64x(0x8040201008040201);
+	__m128i const bytes = _mm_shuffle_epi8(_mm_cvtsi32_si128(uint32_t(bits)),
+		_mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1));
+	return _mm_cmpeq_epi8(_mm_and_si128(bytes, bit), bit);
+}
+
+// byte mask of 32 chars, as per the low 32 bits of a bitmap
+PRUNER_TARGET_AVX2 inline __m256i bytemask32(
+	uint64_t const bits) {
+
+	__m256i const bit = _mm256_set1_epi64x(0x8040201008040201);
+	__m256i const bytes = _mm256_shuffle_epi8(_mm256_set1_epi32(uint32_t(bits)), _mm256_setr_epi8(
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+		2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3));
+	return _mm256_cmpeq_epi8(_mm256_and_si256(bytes, bit), bit);
+}
+
+// quote-aware version of testee04, 64-batch
+template < class blank, bool escapes >
+PRUNER_TARGET_SSSE3 inline size_t quoted04(
+	uint8_t const* const input,
+	uint8_t* const output,
+	quote_state& state) {
+	__m128i const vin0 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 0);
+	__m128i const vin1 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 1);
+	__m128i const vin2 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 2);
+	__m128i const vin3 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 3);
+
+	__m128i const quote = _mm_set1_epi8('"');
+	__m128i const bslash = _mm_set1_epi8('\\');
+
+#define BITMAP(op) \
+	(uint64_t(uint32_t(_mm_movemask_epi8(op(vin0)))) <<  0 | uint64_t(uint32_t(_mm_movemask_epi8(op(vin1)))) << 16 | \
+	 uint64_t(uint32_t(_mm_movemask_epi8(op(vin2)))) << 32 | uint64_t(uint32_t(_mm_movemask_epi8(op(vin3)))) << 48)
+#define QUOTE(v) _mm_cmpeq_epi8(v, quote)
+#define BSLASH(v) _mm_cmpeq_epi8(v, bslash)
+
+	uint64_t const blanks = BITMAP(blank::mask);
+	uint64_t const quotes = BITMAP(QUOTE);
+	uint64_t const bslashes = escapes ? BITMAP(BSLASH) : 0;
+
+#undef BSLASH
+#undef QUOTE
+#undef BITMAP
+	uint64_t const drop = blanks & ~quote_mask< escapes >(quotes, bslashes, state);
+
+	size_t pos = 0;
+	pos += testee04_compact(vin0, bytemask16(drop >>  0), output + pos);
+	pos += testee04_compact(vin1, bytemask16(drop >> 16), output + pos);
+	pos += testee04_compact(vin2, bytemask16(drop >> 32), output + pos);
+	pos += testee04_compact(vin3, bytemask16(drop >> 48), output + pos);
+	return pos;
+}
+
+// quote-aware version of testee09, 64-batch
+template < class blank, bool escapes >
+PRUNER_TARGET_AVX2 inline size_t quoted09(
+	uint8_t const* const input,
+	uint8_t* const output,
+	quote_state& state) {
+	__m256i const vin0 = _mm256_loadu_si256(reinterpret_cast< __m256i const* >(input) + 0);
+	__m256i const vin1 = _mm256_loadu_si256(reinterpret_cast< __m256i const* >(input) + 1);
+
+	__m256i const quote = _mm256_set1_epi8('"');
+	__m256i const bslash = _mm256_set1_epi8('\\');
+
+#define BITMAP(op) \
+	(uint64_t(uint32_t(_mm256_movemask_epi8(op(vin0)))) | uint64_t(uint32_t(_mm256_movemask_epi8(op(vin1)))) << 32)
+#define QUOTE(v) _mm256_cmpeq_epi8(v, quote)
+#define BSLASH(v) _mm256_cmpeq_epi8(v, bslash)
+
+	uint64_t const blanks = BITMAP(blank::mask);
+	uint64_t const quotes = BITMAP(QUOTE);
+	uint64_t const bslashes = escapes ? BITMAP(BSLASH) : 0;
+
+#undef BSLASH
+#undef QUOTE
+#undef BITMAP
+	uint64_t const drop = blanks & ~quote_mask< escapes >(quotes, bslashes, state);
+
+	size_t const len0 = testee09_compact(vin0, bytemask32(drop), output);
+	size_t const len1 = testee09_compact(vin1, bytemask32(drop >> 32), output + len0);
+	return len0 + len1;
+}
+
+// quote-aware version of testee10, 64-batch
+template < class blank, bool escapes >
+PRUNER_TARGET_AVX512VBMI2 inline size_t quoted10(
+	uint8_t const* const input,
+	uint8_t* const output,
+	quote_state& state) {
+	__m512i const vin = _mm512_loadu_si512(input);
+
+	uint64_t const blanks = ~blank::keep(vin);
+	uint64_t const quotes = _mm512_cmpeq_epi8_mask(vin, _mm512_set1_epi8('"'));
+	uint64_t const bslashes = escapes ? _mm512_cmpeq_epi8_mask(vin, _mm512_set1_epi8('\\')) : 0;
+
+	__mmask64 const keep = ~(blanks & ~quote_mask< escapes >(quotes, bslashes, state));
+
+	_mm512_storeu_si512(output, _mm512_maskz_compress_epi8(keep, vin));
+	return __builtin_popcountll(keep);
+}
+
+#endif
+
+// Adaptive testees, for inputs where most batches are either free of blanks or all blanks, e.g. logs or padded
+// records: each consumes a 64-char block and first gets the bitmap of its blanks. A block without blanks is copied as
+// is, a block of blanks alone is skipped, and the rest go batch by batch, where the same goes for each batch, before
+// any compaction. The counters tell how often each path was taken.
+
+// counts of the paths taken by the adaptive testees
+struct prune_paths {
+	size_t clean_blocks;  // 64-char blocks without blanks, copied
+	size_t blank_blocks;  // 64-char blocks of blanks alone, skipped
+	size_t clean_batches; // batches of the rest of the blocks without blanks, copied
+	size_t blank_batches; // batches of the rest of the blocks of blanks alone, skipped
+	size_t mixed_batches; // batches compacted
+};
+
+#if __aarch64__
+// adaptive version of a testee07 batch, as per the bitmap of its blanks
+template < bool same_latency_q_and_d >
+inline size_t adaptive07_batch(
+	uint8x16_t const vin0,
+	uint8x16_t const vin1,
+	uint8x16_t const bmask0,
+	uint8x16_t const bmask1,
+	uint32_t const blanks,
+	uint8_t* const output,
+	prune_paths& paths) {
+
+	if (blanks == 0) {
+		vst1q_u8(output, vin0);
+		vst1q_u8(output + sizeof(uint8x16_t), vin1);
+		++paths.clean_batches;
+		return sizeof(uint8x16_t) * 2;
+	}
+
+	if (blanks == ~uint32_t(0)) {
+		++paths.blank_batches;
+		return 0;
+	}
+
+	++paths.mixed_batches;
+	return testee07_compact< same_latency_q_and_d >(vin0, vin1, bmask0, bmask1, output);
+}
+
+// adaptive version of testee07, 64-batch
+template < bool same_latency_q_and_d, class blank >
+inline size_t adaptive07(
+	uint8_t const* const input,
+	uint8_t* const output,
+	prune_paths& paths) {
+	uint8x16_t const vin0 = vld1q_u8(input);
+	uint8x16_t const vin1 = vld1q_u8(input + sizeof(uint8x16_t) * 1);
+	uint8x16_t const vin2 = vld1q_u8(input + sizeof(uint8x16_t) * 2);
+	uint8x16_t const vin3 = vld1q_u8(input + sizeof(uint8x16_t) * 3);
+	uint8x16_t const bmask0 = blank::mask(vin0);
+	uint8x16_t const bmask1 = blank::mask(vin1);
+	uint8x16_t const bmask2 = blank::mask(vin2);
+	uint8x16_t const bmask3 = blank::mask(vin3);
+
+	uint64_t const blanks = bitmap64(bmask0, bmask1, bmask2, bmask3);
+
+	if (blanks == 0) {
+		vst1q_u8(output, vin0);
+		vst1q_u8(output + sizeof(uint8x16_t) * 1, vin1);
+		vst1q_u8(output + sizeof(uint8x16_t) * 2, vin2);
+		vst1q_u8(output + sizeof(uint8x16_t) * 3, vin3);
+		++paths.clean_blocks;
+		return 64;
+	}
+
+	if (blanks == ~uint64_t(0)) {
+		++paths.blank_blocks;
+		return 0;
+	}
+
+	size_t const len0 = adaptive07_batch< same_latency_q_and_d >(
+		vin0, vin1, bmask0, bmask1, uint32_t(blanks), output, paths);
+	size_t const len1 = adaptive07_batch< same_latency_q_and_d >(
+		vin2, vin3, bmask2, bmask3, uint32_t(blanks >> 32), output + len0, paths);
+	return len0 + len1;
+}
+
+#elif __x86_64__ || __i386__
+// adaptive version of a testee04 batch, as per the bitmap of its blanks
+PRUNER_TARGET_SSSE3 inline size_t adaptive04_batch(
+	__m128i const vin,
+	__m128i const bmask,
+	uint32_t const blanks,
+	uint8_t* const output,
+	prune_paths& paths) {
+
+	if (blanks == 0) {
+		_mm_storeu_si128(reinterpret_cast< __m128i* >(output), vin);
+		++paths.clean_batches;
+		return sizeof(__m128i);
+	}
+
+	if (blanks == 0xffff) {
+		++paths.blank_batches;
+		return 0;
+	}
+
+	++paths.mixed_batches;
+	return testee04_compact(vin, bmask, output);
+}
+
+// adaptive version of testee04, 64-batch
+template < class blank >
+PRUNER_TARGET_SSSE3 inline size_t adaptive04(
+	uint8_t const* const input,
+	uint8_t* const output,
+	prune_paths& paths) {
+	__m128i const vin0 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 0);
+	__m128i const vin1 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 1);
+	__m128i const vin2 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 2);
+	__m128i const vin3 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 3);
+	__m128i const bmask0 = blank::mask(vin0);
+	__m128i const bmask1 = blank::mask(vin1);
+	__m128i const bmask2 = blank::mask(vin2);
+	__m128i const bmask3 = blank::mask(vin3);
+
+	uint64_t const blanks =
+		uint64_t(uint32_t(_mm_movemask_epi8(bmask0))) <<  0 | uint64_t(uint32_t(_mm_movemask_epi8(bmask1))) << 16 |
+		uint64_t(uint32_t(_mm_movemask_epi8(bmask2))) << 32 | uint64_t(uint32_t(_mm_movemask_epi8(bmask3))) << 48;
+
+	if (blanks == 0) {
+		_mm_storeu_si128(reinterpret_cast< __m128i* >(output) + 0, vin0);
+		_mm_storeu_si128(reinterpret_cast< __m128i* >(output) + 1, vin1);
+		_mm_storeu_si128(reinterpret_cast< __m128i* >(output) + 2, vin2);
+		_mm_storeu_si128(reinterpret_cast< __m128i* >(output) + 3, vin3);
+		++paths.clean_blocks;
+		return 64;
+	}
+
+	if (blanks == ~uint64_t(0)) {
+		++paths.blank_blocks;
+		return 0;
+	}
+
+	size_t pos = 0;
+	pos += adaptive04_batch(vin0, bmask0, uint16_t(blanks >>  0), output + pos, paths);
+	pos += adaptive04_batch(vin1, bmask1, uint16_t(blanks >> 16), output + pos, paths);
+	pos += adaptive04_batch(vin2, bmask2, uint16_t(blanks >> 32), output + pos, paths);
+	pos += adaptive04_batch(vin3, bmask3, uint16_t(blanks >> 48), output + pos, paths);
+	return pos;
+}
+
+// adaptive version of a testee09 batch, as per the bitmap of its blanks
+PRUNER_TARGET_AVX2 inline size_t adaptive09_batch(
+	__m256i const vin,
+	__m256i const bmask,
+	uint32_t const blanks,
+	uint8_t* const output,
+	prune_paths& paths) {
+
+	if (blanks == 0) {
+		_mm256_storeu_si256(reinterpret_cast< __m256i* >(output), vin);
+		++paths.clean_batches;
+		return sizeof(__m256i);
+	}
+
+	if (blanks == ~uint32_t(0)) {
+		++paths.blank_batches;
+		return 0;
+	}
+
+	++paths.mixed_batches;
+	return testee09_compact(vin, bmask, output);
+}
+
+// adaptive version of testee09, 64-batch
+template < class blank >
+PRUNER_TARGET_AVX2 inline size_t adaptive09(
+	uint8_t const* const input,
+	uint8_t* const output,
+	prune_paths& paths) {
+	__m256i const vin0 = _mm256_loadu_si256(reinterpret_cast< __m256i const* >(input) + 0);
+	__m256i const vin1 = _mm256_loadu_si256(reinterpret_cast< __m256i const* >(input) + 1);
+	__m256i const bmask0 = blank::mask(vin0);
+	__m256i const bmask1 = blank::mask(vin1);
+
+	uint64_t const blanks =
+		uint64_t(uint32_t(_mm256_movemask_epi8(bmask0))) | uint64_t(uint32_t(_mm256_movemask_epi8(bmask1))) << 32;
+
+	if (blanks == 0) {
+		_mm256_storeu_si256(reinterpret_cast< __m256i* >(output) + 0, vin0);
+		_mm256_storeu_si256(reinterpret_cast< __m256i* >(output) + 1, vin1);
+		++paths.clean_blocks;
+		return 64;
+	}
+
+	if (blanks == ~uint64_t(0)) {
+		++paths.blank_blocks;
+		return 0;
+	}
+
+	size_t const len0 = adaptive09_batch(vin0, bmask0, uint32_t(blanks), output, paths);
+	size_t const len1 = adaptive09_batch(vin1, bmask1, uint32_t(blanks >> 32), output + len0, paths);
+	return len0 + len1;
+}
+
+// adaptive version of testee10, 64-batch; its batch is the block
+template < class blank >
+PRUNER_TARGET_AVX512VBMI2 inline size_t adaptive10(
+	uint8_t const* const input,
+	uint8_t* const output,
+	prune_paths& paths) {
+	__m512i const vin = _mm512_loadu_si512(input);
+	__mmask64 const keep = blank::keep(vin);
+
+	if (keep == ~uint64_t(0)) {
+		_mm512_storeu_si512(output, vin);
+		++paths.clean_blocks;
+		return 64;
+	}
+
+	if (keep == 0) {
+		++paths.blank_blocks;
+		return 0;
+	}
+
+	++paths.mixed_batches;
+	_mm512_storeu_si512(output, _mm512_maskz_compress_epi8(keep, vin));
+	return __builtin_popcountll(keep);
+}
+
+#endif
+
+// Position testees: batch testees that also write, for each non-blank they keep, its offset in the source -- 'base'
+// plus its lane -- to 'positions', at the index of the kept char in 'output'. The sorted index of the pruners proper
+// is just that, less the base: it takes no more than widening it to 32 bits. Past the returned count 'positions' may
+// get garbage too, up to a full batch of offsets.
+template < class blank >
+inline size_t positions00(
+	uint8_t const* const input,
+	uint8_t* const output,
+	uint32_t* const positions,
+	uint32_t const base) {
+	size_t i = 0, pos = 0;
+	while (i < 16) {
+		uint8_t const c = input[i];
+		output[pos] = c;
+		positions[pos] = base + i++;
+		pos += (blank::scalar(c) ? 0 : 1);
+	}
+	return pos;
+}
+
+#if __aarch64__
+// position version of testee11, 16-batch
+template < class blank >
+inline size_t positions11(
+	uint8_t const* const input,
+	uint8_t* const output,
+	uint32_t* const positions,
+	uint32_t const base) {
+	uint8x16_t const vin = vld1q_u8(input);
+	uint8x16_t const bmask = blank::mask(vin);
+	uint8x16_t const risen = vorrq_u8(bmask, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
+	uint8x16_t const index = network_sort< network_green16 >(risen);
+
+	uint32x4_t const vbase = vdupq_n_u32(base);
+	uint16x8_t const index0 = vmovl_u8(vget_low_u8(index));
+	uint16x8_t const index1 = vmovl_high_u8(index);
+
+	vst1q_u8(output, vqtbl1q_u8(vin, index));
+	vst1q_u32(positions + 0, vaddw_u16(vbase, vget_low_u16(index0)));
+	vst1q_u32(positions + 4, vaddw_high_u16(vbase, index0));
+	vst1q_u32(positions + 8, vaddw_u16(vbase, vget_low_u16(index1)));
+	vst1q_u32(positions + 12, vaddw_high_u16(vbase, index1));
+	return sizeof(uint8x16_t) + int8_t(vaddvq_u8(bmask));
+}
+
+#elif __x86_64__ || __i386__
+// position version of testee11, 16-batch
+template < class blank >
+PRUNER_TARGET_SSSE3 inline size_t positions11(
+	uint8_t const* const input,
+	uint8_t* const output,
+	uint32_t* const positions,
+	uint32_t const base) {
+	__m128i const vin = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input));
+	__m128i const bmask = blank::mask(vin);
+	__m128i const risen = _mm_or_si128(bmask, _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+	__m128i const index = network_sort< network_green16 >(risen);
+
+	__m128i const zero = _mm_setzero_si128();
+	__m128i const vbase = _mm_set1_epi32(base);
+	__m128i const index0 = _mm_unpacklo_epi8(index, zero);
+	__m128i const index1 = _mm_unpackhi_epi8(index, zero);
+	__m128i* const vpositions = reinterpret_cast< __m128i* >(positions);
+
+	_mm_storeu_si128(reinterpret_cast< __m128i* >(output), _mm_shuffle_epi8(vin, index));
+	_mm_storeu_si128(vpositions + 0, _mm_add_epi32(vbase, _mm_unpacklo_epi16(index0, zero)));
+	_mm_storeu_si128(vpositions + 1, _mm_add_epi32(vbase, _mm_unpackhi_epi16(index0, zero)));
+	_mm_storeu_si128(vpositions + 2, _mm_add_epi32(vbase, _mm_unpacklo_epi16(index1, zero)));
+	_mm_storeu_si128(vpositions + 3, _mm_add_epi32(vbase, _mm_unpackhi_epi16(index1, zero)));
+	return sizeof(__m128i) - _mm_popcnt_u32(_mm_movemask_epi8(bmask));
+}
+
+// position version of testee12, 32-batch; the offsets of the upper 128-bit lane follow those of the lower one
+template < class blank >
+PRUNER_TARGET_AVX2 inline size_t positions12(
+	uint8_t const* const input,
+	uint8_t* const output,
+	uint32_t* const positions,
+	uint32_t const base) {
+	__m256i const vin = _mm256_loadu_si256(reinterpret_cast< __m256i const* >(input));
+	__m256i const bmask = blank::mask(vin);
+	__m256i const risen = _mm256_or_si256(bmask, _mm256_setr_epi8(
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+	__m256i const index = network_sort< network_green16 >(risen);
+	__m256i const res = _mm256_shuffle_epi8(vin, index);
+
+	uint32_t const bitmask = ~_mm256_movemask_epi8(bmask);
+	uint32_t const len0 = _mm_popcnt_u32(bitmask & 0xffff);
+
+	__m128i const index0 = _mm256_castsi256_si128(index);
+	__m128i const index1 = _mm256_extracti128_si256(index, 1);
+	__m256i const vbase0 = _mm256_set1_epi32(base);
+	__m256i const vbase1 = _mm256_set1_epi32(base + 16);
+	__m256i* const vpositions0 = reinterpret_cast< __m256i* >(positions);
+	__m256i* const vpositions1 = reinterpret_cast< __m256i* >(positions + len0);
+
+	_mm_storeu_si128(reinterpret_cast< __m128i* >(output), _mm256_castsi256_si128(res));
+	_mm_storeu_si128(reinterpret_cast< __m128i* >(output + len0), _mm256_extracti128_si256(res, 1));
+	_mm256_storeu_si256(vpositions0 + 0, _mm256_add_epi32(vbase0, _mm256_cvtepu8_epi32(index0)));
+	_mm256_storeu_si256(vpositions0 + 1, _mm256_add_epi32(vbase0, _mm256_cvtepu8_epi32(_mm_srli_si128(index0, 8))));
+	_mm256_storeu_si256(vpositions1 + 0, _mm256_add_epi32(vbase1, _mm256_cvtepu8_epi32(index1)));
+	_mm256_storeu_si256(vpositions1 + 1, _mm256_add_epi32(vbase1, _mm256_cvtepu8_epi32(_mm_srli_si128(index1, 8))));
+	return _mm_popcnt_u32(bitmask);
+}
+
+// position version of testee10, 64-batch; no index to widen here, so the offsets get compressed on their own, 16 at a
+// time
+template < class blank >
+PRUNER_TARGET_AVX512VBMI2 inline size_t positions10(
+	uint8_t const* const input,
+	uint8_t* const output,
+	uint32_t* const positions,
+	uint32_t const base) {
+	__m512i const vin = _mm512_loadu_si512(input);
+	__mmask64 const keep = blank::keep(vin);
+	__m512i const offsets = _mm512_add_epi32(_mm512_set1_epi32(base),
+		_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+
+	size_t const len0 = _mm_popcnt_u32(uint16_t(keep));
+	size_t const len1 = _mm_popcnt_u32(uint16_t(keep >> 16)) + len0;
+	size_t const len2 = _mm_popcnt_u32(uint16_t(keep >> 32)) + len1;
+
+	_mm512_storeu_si512(output, _mm512_maskz_compress_epi8(keep, vin));
+	_mm512_storeu_si512(positions, _mm512_maskz_compress_epi32(__mmask16(keep), offsets));
+	_mm512_storeu_si512(positions + len0,
+		_mm512_maskz_compress_epi32(__mmask16(keep >> 16), _mm512_add_epi32(offsets, _mm512_set1_epi32(16))));
+	_mm512_storeu_si512(positions + len1,
+		_mm512_maskz_compress_epi32(__mmask16(keep >> 32), _mm512_add_epi32(offsets, _mm512_set1_epi32(32))));
+	_mm512_storeu_si512(positions + len2,
+		_mm512_maskz_compress_epi32(__mmask16(keep >> 48), _mm512_add_epi32(offsets, _mm512_set1_epi32(48))));
+	return __builtin_popcountll(keep);
+}
+
+#endif
+
+// UTF-8 testees, for text past ASCII: the predicate's blanks go as ever -- the predicate gets to see ASCII chars alone
+// -- and so do the multi-char sequences of the Unicode blanks, all of their chars: U+0085 and U+00A0 in 2 chars,
+// U+1680, U+2000 to U+200A, U+2028, U+2029, U+202F, U+205F and U+3000 in 3. Each testee consumes a 64-char block,
+// checks it for well-formed UTF-8 on the way, and marks the starts of the blank sequences by comparing each char and
+// the two after it; the sequences then go to the compaction of the matching pruner proper, as the blanks do. A
+// sequence whose start is cut by the end of a block is held back from the output until the next block tells whether
+// it completes. Blocks of ASCII alone with nothing carried over skip all but the blanks.
+
+// state of a UTF-8 pruning, carried from block to block, and from call to call
+struct utf8_state {
+	uint64_t cont;     // one bit per continuation char due at the start of the next block
+	uint64_t error;    // non-zero once the text is found ill-formed
+	uint32_t held;     // chars held back, the start of a blank sequence cut by the end of the previous block
+	uint32_t held_len;
+	uint32_t last;     // last char of the previous block
+};
+
+// bitmaps of a 64-char block, for the UTF-8 testees
+struct utf8_bitmaps {
+	uint64_t high;   // chars past ASCII
+	uint64_t cont;   // continuation chars
+	uint64_t lead3;  // lead chars of 3 chars or more
+	uint64_t lead4;  // lead chars of 4 chars or more
+	uint64_t bad;    // chars ill-formed where they stand: overlong, surrogate or past U+10FFFF
+	uint64_t start2; // starts of 2-char blank sequences
+	uint64_t start3; // starts of 3-char blank sequences
+};
+
+// length of the blank sequence starting s[0, len), or zero when there is none; past len any char matches, so a length
+// above len tells of a sequence cut short
+inline size_t utf8_blank_len(
+	uint8_t const* const s,
+	size_t const len) {
+
+	uint32_t const c1 = len > 1 ? s[1] : 0x100;
+	uint32_t const c2 = len > 2 ? s[2] : 0x100;
+
+	switch (s[0]) {
+	case 0xc2: // U+0085, U+00A0
+		return c1 == 0x85 || c1 == 0xa0 || c1 > 0xff ? 2 : 0;
+	case 0xe1: // U+1680
+		return (c1 == 0x9a || c1 > 0xff) && (c2 == 0x80 || c2 > 0xff) ? 3 : 0;
+	case 0xe2: // U+2000 to U+200A, U+2028, U+2029, U+202F; U+205F
+		return ((c1 == 0x80 || c1 > 0xff) && ((c2 >= 0x80 && c2 <= 0x8a) || c2 == 0xa8 || c2 == 0xa9 || c2 == 0xaf ||
+			c2 > 0xff)) || ((c1 == 0x81 || c1 > 0xff) && (c2 == 0x9f || c2 > 0xff)) ? 3 : 0;
+	case 0xe3: // U+3000
+		return (c1 == 0x80 || c1 > 0xff) && (c2 == 0x80 || c2 > 0xff) ? 3 : 0;
+	default:
+		return 0;
+	}
+}
+
+// length of the blank sequence started by the chars held back, given the first chars of the block that follows, of
+// which there are len; zero when the held chars start none after all
+inline size_t utf8_resume(
+	uint8_t const* const input,
+	size_t const len,
+	utf8_state const& state) {
+
+	uint8_t seq[4];
+	size_t const n = len < 2 ? len : 2;
+	memcpy(seq, &state.held, state.held_len);
+	memcpy(seq + state.held_len, input, n);
+	return utf8_blank_len(seq, state.held_len + n);
+}
+
+// Mask of the chars to drop from a 64-char block, as per its bitmaps and the blanks of the predicate; the chars held
+// back from the previous block go to output, unless they turn out a blank sequence, and their count to pos. The
+// continuation chars due are those of the leads before them, both from within the block and carried over, and must
+// be all of its continuation chars. Holds back the start of a blank sequence cut by the end of the block.
+inline uint64_t utf8_block(
+	uint8_t const* const input,
+	uint8_t* const output,
+	size_t& pos,
+	uint64_t const blanks,
+	utf8_bitmaps const& b,
+	utf8_state& state) {
+
+	uint64_t const lead = b.high & ~b.cont;
+	uint64_t const due = lead << 1 | b.lead3 << 2 | b.lead4 << 3 | state.cont;
+	state.cont = lead >> 63 | b.lead3 >> 62 | b.lead4 >> 61;
+	state.error |= (due ^ b.cont) | b.bad;
+
+	uint64_t drop = (blanks & ~b.high) | b.start2 | b.start2 << 1 | b.start3 | b.start3 << 1 | b.start3 << 2;
+
+	if (state.held_len != 0) {
+		size_t const seq_len = utf8_resume(input, 64, state);
+
+		if (seq_len != 0)
+			drop |= (uint64_t(1) << (seq_len - state.held_len)) - 1;
+		else {
+			memcpy(output, &state.held, sizeof(state.held));
+			pos = state.held_len;
+		}
+	}
+
+	size_t const held_len = utf8_blank_len(input + 62, 2) > 2 ? 2 : utf8_blank_len(input + 63, 1) > 1 ? 1 : 0;
+
+	state.held = 0;
+	memcpy(&state.held, input + 64 - held_len, held_len);
+	state.held_len = held_len;
+	state.last = input[63];
+	return drop | ~(~uint64_t(0) >> held_len);
+}
+
+// scalar version, over any count of chars; also does the sub-block tails of the vector versions
+template < class blank >
+inline size_t utf8_00(
+	uint8_t const* const input,
+	size_t const len,
+	uint8_t* const output,
+	utf8_state& state) {
+	size_t pos = 0, skip = 0;
+
+	if (state.held_len != 0) {
+		size_t const seq_len = utf8_resume(input, len, state);
+
+		if (seq_len == 0) {
+			memcpy(output, &state.held, state.held_len);
+			pos = state.held_len;
+			state.held = state.held_len = 0;
+		}
+		else if (seq_len > state.held_len + len) {
+			// cut short once again: hold back all of the chars
+			memcpy(reinterpret_cast< uint8_t* >(&state.held) + state.held_len, input, len);
+			state.held_len += len;
+			skip = len;
+		}
+		else {
+			skip = seq_len - state.held_len;
+			state.held = state.held_len = 0;
+		}
+	}
+
+	for (size_t i = 0; i < len; ++i) {
+		uint8_t const c = input[i];
+		uint32_t const last = state.last;
+
+		state.error |= (state.cont & 1) ^ ((c & 0xc0) == 0x80 ? 1 : 0);
+		state.error |= c == 0xc0 || c == 0xc1 || c >= 0xf5 ||
+			(last == 0xe0 && c >= 0x80 && c < 0xa0) || (last == 0xed && c >= 0xa0) ||
+			(last == 0xf0 && c >= 0x80 && c < 0x90) || (last == 0xf4 && c >= 0x90) ? 1 : 0;
+		state.cont = state.cont >> 1 | (c >= 0xf0 ? 7 : c >= 0xe0 ? 3 : c >= 0xc0 ? 1 : 0);
+		state.last = c;
+
+		if (skip == 0 && c >= 0xc2) {
+			skip = utf8_blank_len(input + i, len - i);
+
+			// cut short by the end of the chars: hold back the rest of them
+			if (skip > len - i) {
+				memcpy(&state.held, input + i, len - i);
+				state.held_len = len - i;
+			}
+		}
+
+		output[pos] = c;
+		pos += skip == 0 && (c >= 0x80 || !blank::scalar(c)) ? 1 : 0;
+		skip -= skip != 0 ? 1 : 0;
+	}
+	return pos;
+}
+
+// the end of a UTF-8 text: the chars still held back go to output, as the start of a blank sequence never completed;
+// returns their count. The text is well-formed when no error came up, and no continuation chars are due
+inline size_t utf8_finish(
+	uint8_t* const output,
+	utf8_state& state) {
+
+	size_t const held_len = state.held_len;
+	memcpy(output, &state.held, held_len);
+
+	state.error |= state.cont;
+	state.cont = 0;
+	state.held = state.held_len = 0;
+	return held_len;
+}
+
+#if __aarch64__
+// classes of the chars of a 16-char vector, given the vectors before and after it, as per utf8_bitmaps
+struct utf8_classes {
+	uint8x16_t cont;
+	uint8x16_t lead3;
+	uint8x16_t lead4;
+	uint8x16_t bad;
+	uint8x16_t start2;
+	uint8x16_t start3;
+};
+
+inline utf8_classes utf8_classify(
+	uint8x16_t const prev,
+	uint8x16_t const v,
+	uint8x16_t const next) {
+
+	uint8x16_t const p1 = vextq_u8(prev, v, 15);
+	uint8x16_t const n1 = vextq_u8(v, next, 1);
+	uint8x16_t const n2 = vextq_u8(v, next, 2);
+
+#define EQ(a, c) vceqq_u8(a, vdupq_n_u8(c))
+#define IN(a, lo, hi) vandq_u8(vcgeq_u8(a, vdupq_n_u8(lo)), vcleq_u8(a, vdupq_n_u8(hi)))
+
+	utf8_classes classes;
+	classes.cont = IN(v, 0x80, 0xbf);
+	classes.lead3 = vcgeq_u8(v, vdupq_n_u8(0xe0));
+	classes.lead4 = vcgeq_u8(v, vdupq_n_u8(0xf0));
+
+	// C0, C1 and F5 to FF; E0 and F0 leading overlong forms, ED surrogates, F4 code points past U+10FFFF
+	classes.bad = vorrq_u8(
+		vorrq_u8(IN(v, 0xc0, 0xc1), vcgeq_u8(v, vdupq_n_u8(0xf5))),
+		vorrq_u8(
+			vorrq_u8(vandq_u8(EQ(p1, 0xe0), IN(v, 0x80, 0x9f)), vandq_u8(EQ(p1, 0xed), vcgeq_u8(v, vdupq_n_u8(0xa0)))),
+			vorrq_u8(vandq_u8(EQ(p1, 0xf0), IN(v, 0x80, 0x8f)), vandq_u8(EQ(p1, 0xf4), vcgeq_u8(v, vdupq_n_u8(0x90))))));
+
+	uint8x16_t const n1_80 = EQ(n1, 0x80);
+	classes.start2 = vandq_u8(EQ(v, 0xc2), vorrq_u8(EQ(n1, 0x85), EQ(n1, 0xa0)));
+	classes.start3 = vorrq_u8(
+		vorrq_u8(
+			vandq_u8(EQ(v, 0xe1), vandq_u8(EQ(n1, 0x9a), EQ(n2, 0x80))),
+			vandq_u8(EQ(v, 0xe3), vandq_u8(n1_80, EQ(n2, 0x80)))),
+		vandq_u8(EQ(v, 0xe2), vorrq_u8(
+			vandq_u8(n1_80, vorrq_u8(IN(n2, 0x80, 0x8a), vorrq_u8(IN(n2, 0xa8, 0xa9), EQ(n2, 0xaf)))),
+			vandq_u8(EQ(n1, 0x81), EQ(n2, 0x9f)))));
+
+#undef IN
+#undef EQ
+	return classes;
+}
+
+// UTF-8 version of testee07, 64-batch
+template < bool same_latency_q_and_d, class blank >
+inline size_t utf8_07(
+	uint8_t const* const input,
+	uint8_t* const output,
+	utf8_state& state) {
+	uint8x16_t const vin0 = vld1q_u8(input);
+	uint8x16_t const vin1 = vld1q_u8(input + sizeof(uint8x16_t) * 1);
+	uint8x16_t const vin2 = vld1q_u8(input + sizeof(uint8x16_t) * 2);
+	uint8x16_t const vin3 = vld1q_u8(input + sizeof(uint8x16_t) * 3);
+
+	uint64_t const blanks = bitmap64(blank::mask(vin0), blank::mask(vin1), blank::mask(vin2), blank::mask(vin3));
+	uint8x16_t const high = vorrq_u8(vorrq_u8(vin0, vin1), vorrq_u8(vin2, vin3));
+
+	uint64_t drop = blanks;
+	size_t pos = 0;
+
+	if (vmaxvq_u8(high) >= 0x80 || state.cont != 0 || state.held_len != 0) {
+		uint8x16_t const sign = vdupq_n_u8(0x80);
+		uint8x16_t const prev = vsetq_lane_u8(uint8_t(state.last), vdupq_n_u8(0), 15);
+
+		utf8_classes const c0 = utf8_classify(prev, vin0, vin1);
+		utf8_classes const c1 = utf8_classify(vin0, vin1, vin2);
+		utf8_classes const c2 = utf8_classify(vin1, vin2, vin3);
+		utf8_classes const c3 = utf8_classify(vin2, vin3, vdupq_n_u8(0));
+
+		utf8_bitmaps b;
+		b.high = bitmap64(vcgeq_u8(vin0, sign), vcgeq_u8(vin1, sign), vcgeq_u8(vin2, sign), vcgeq_u8(vin3, sign));
+		b.cont = bitmap64(c0.cont, c1.cont, c2.cont, c3.cont);
+		b.lead3 = bitmap64(c0.lead3, c1.lead3, c2.lead3, c3.lead3);
+		b.lead4 = bitmap64(c0.lead4, c1.lead4, c2.lead4, c3.lead4);
+		b.bad = bitmap64(c0.bad, c1.bad, c2.bad, c3.bad);
+		b.start2 = bitmap64(c0.start2, c1.start2, c2.start2, c3.start2);
+		b.start3 = bitmap64(c0.start3, c1.start3, c2.start3, c3.start3);
+
+		drop = utf8_block(input, output, pos, blanks, b, state);
+	}
+	else
+		state.last = input[63];
+
+	pos += testee07_compact< same_latency_q_and_d >(vin0, vin1, bytemask16(drop), bytemask16(drop >> 16), output + pos);
+	pos += testee07_compact< same_latency_q_and_d >(vin2, vin3, bytemask16(drop >> 32), bytemask16(drop >> 48),
+		output + pos);
+	return pos;
+}
+
+#elif __x86_64__ || __i386__
+// classes of the chars of a 16-char vector, given the vectors before and after it, into the bitmaps from bit 'shift'
+PRUNER_TARGET_SSSE3 inline void utf8_classify(
+	__m128i const prev,
+	__m128i const v,
+	__m128i const next,
+	size_t const shift,
+	utf8_bitmaps& b) {
+
+	__m128i const p1 = _mm_alignr_epi8(v, prev, 15);
+	__m128i const n1 = _mm_alignr_epi8(next, v, 1);
+	__m128i const n2 = _mm_alignr_epi8(next, v, 2);
+
+	// LT compares signed, so of the chars past ASCII it takes those below c, and no others
+#define EQ(a, c) _mm_cmpeq_epi8(a, _mm_set1_epi8(char(c)))
+#define LT(a, c) _mm_cmplt_epi8(a, _mm_set1_epi8(char(c)))
+#define GE(a, c) _mm_cmpeq_epi8(_mm_max_epu8(a, _mm_set1_epi8(char(c))), a)
+#define BITS(m) (uint64_t(uint32_t(_mm_movemask_epi8(m))) << shift)
+
+	// C0, C1 and F5 to FF; E0 and F0 leading overlong forms, ED surrogates, F4 code points past U+10FFFF
+	__m128i const bad = _mm_or_si128(
+		_mm_or_si128(EQ(_mm_and_si128(v, _mm_set1_epi8(char(0xfe))), 0xc0), GE(v, 0xf5)),
+		_mm_or_si128(
+			_mm_or_si128(_mm_and_si128(EQ(p1, 0xe0), LT(v, 0xa0)), _mm_and_si128(EQ(p1, 0xed), GE(v, 0xa0))),
+			_mm_or_si128(_mm_and_si128(EQ(p1, 0xf0), LT(v, 0x90)), _mm_and_si128(EQ(p1, 0xf4), GE(v, 0x90)))));
+
+	__m128i const n1_80 = EQ(n1, 0x80);
+	__m128i const start2 = _mm_and_si128(EQ(v, 0xc2), _mm_or_si128(EQ(n1, 0x85), EQ(n1, 0xa0)));
+	__m128i const start3 = _mm_or_si128(
+		_mm_or_si128(
+			_mm_and_si128(EQ(v, 0xe1), _mm_and_si128(EQ(n1, 0x9a), EQ(n2, 0x80))),
+			_mm_and_si128(EQ(v, 0xe3), _mm_and_si128(n1_80, EQ(n2, 0x80)))),
+		_mm_and_si128(EQ(v, 0xe2), _mm_or_si128(
+			_mm_and_si128(n1_80, _mm_or_si128(
+				_mm_or_si128(LT(n2, 0x8b), EQ(_mm_and_si128(n2, _mm_set1_epi8(char(0xfe))), 0xa8)), EQ(n2, 0xaf))),
+			_mm_and_si128(EQ(n1, 0x81), EQ(n2, 0x9f)))));
+
+	b.cont |= BITS(LT(v, 0xc0));
+	b.lead3 |= BITS(GE(v, 0xe0));
+	b.lead4 |= BITS(GE(v, 0xf0));
+	b.bad |= BITS(bad);
+	b.start2 |= BITS(start2);
+	b.start3 |= BITS(start3);
+
+#undef BITS
+#undef GE
+#undef LT
+#undef EQ
+}
+
+// classes of the chars of a 32-char vector, given the vectors before and after it, into the bitmaps from bit 'shift'
+PRUNER_TARGET_AVX2 inline void utf8_classify(
+	__m256i const prev,
+	__m256i const v,
+	__m256i const next,
+	size_t const shift,
+	utf8_bitmaps& b) {
+
+	__m256i const p1 = _mm256_alignr_epi8(v, _mm256_permute2x128_si256(prev, v, 0x21), 15);
+	__m256i const v_next = _mm256_permute2x128_si256(v, next, 0x21);
+	__m256i const n1 = _mm256_alignr_epi8(v_next, v, 1);
+	__m256i const n2 = _mm256_alignr_epi8(v_next, v, 2);
+
+#define EQ(a, c) _mm256_cmpeq_epi8(a, _mm256_set1_epi8(char(c)))
+#define LT(a, c) _mm256_cmpgt_epi8(_mm256_set1_epi8(char(c)), a)
+#define GE(a, c) _mm256_cmpeq_epi8(_mm256_max_epu8(a, _mm256_set1_epi8(char(c))), a)
+#define BITS(m) (uint64_t(uint32_t(_mm256_movemask_epi8(m))) << shift)
+
+	__m256i const bad = _mm256_or_si256(
+		_mm256_or_si256(EQ(_mm256_and_si256(v, _mm256_set1_epi8(char(0xfe))), 0xc0), GE(v, 0xf5)),
+		_mm256_or_si256(
+			_mm256_or_si256(_mm256_and_si256(EQ(p1, 0xe0), LT(v, 0xa0)), _mm256_and_si256(EQ(p1, 0xed), GE(v, 0xa0))),
+			_mm256_or_si256(_mm256_and_si256(EQ(p1, 0xf0), LT(v, 0x90)), _mm256_and_si256(EQ(p1, 0xf4), GE(v, 0x90)))));
+
+	__m256i const n1_80 = EQ(n1, 0x80);
+	__m256i const start2 = _mm256_and_si256(EQ(v, 0xc2), _mm256_or_si256(EQ(n1, 0x85), EQ(n1, 0xa0)));
+	__m256i const start3 = _mm256_or_si256(
+		_mm256_or_si256(
+			_mm256_and_si256(EQ(v, 0xe1), _mm256_and_si256(EQ(n1, 0x9a), EQ(n2, 0x80))),
+			_mm256_and_si256(EQ(v, 0xe3), _mm256_and_si256(n1_80, EQ(n2, 0x80)))),
+		_mm256_and_si256(EQ(v, 0xe2), _mm256_or_si256(
+			_mm256_and_si256(n1_80, _mm256_or_si256(
+				_mm256_or_si256(LT(n2, 0x8b), EQ(_mm256_and_si256(n2, _mm256_set1_epi8(char(0xfe))), 0xa8)),
+				EQ(n2, 0xaf))),
+			_mm256_and_si256(EQ(n1, 0x81), EQ(n2, 0x9f)))));
+
+	b.cont |= BITS(LT(v, 0xc0));
+	b.lead3 |= BITS(GE(v, 0xe0));
+	b.lead4 |= BITS(GE(v, 0xf0));
+	b.bad |= BITS(bad);
+	b.start2 |= BITS(start2);
+	b.start3 |= BITS(start3);
+
+#undef BITS
+#undef GE
+#undef LT
+#undef EQ
+}
+
+// UTF-8 version of testee04, 64-batch
+template < class blank >
+PRUNER_TARGET_SSSE3 inline size_t utf8_04(
+	uint8_t const* const input,
+	uint8_t* const output,
+	utf8_state& state) {
+	__m128i const vin0 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 0);
+	__m128i const vin1 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 1);
+	__m128i const vin2 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 2);
+	__m128i const vin3 = _mm_loadu_si128(reinterpret_cast< __m128i const* >(input) + 3);
+
+#define BITMAP(op) \
+	(uint64_t(uint32_t(_mm_movemask_epi8(op(vin0)))) <<  0 | uint64_t(uint32_t(_mm_movemask_epi8(op(vin1)))) << 16 | \
+	 uint64_t(uint32_t(_mm_movemask_epi8(op(vin2)))) << 32 | uint64_t(uint32_t(_mm_movemask_epi8(op(vin3)))) << 48)
+#define HIGH(v) (v)
+
+	uint64_t const blanks = BITMAP(blank::mask);
+	uint64_t const high = BITMAP(HIGH);
+
+#undef HIGH
+#undef BITMAP
+	uint64_t drop = blanks;
+	size_t pos = 0;
+
+	if (high != 0 || state.cont != 0 || state.held_len != 0) {
+		__m128i const prev = _mm_slli_si128(_mm_cvtsi32_si128(state.last), 15);
+		utf8_bitmaps b = { high, 0, 0, 0, 0, 0, 0 };
+
+		utf8_classify(prev, vin0, vin1, 0, b);
+		utf8_classify(vin0, vin1, vin2, 16, b);
+		utf8_classify(vin1, vin2, vin3, 32, b);
+		utf8_classify(vin2, vin3, _mm_setzero_si128(), 48, b);
+
+		drop = utf8_block(input, output, pos, blanks, b, state);
+	}
+	else
+		state.last = input[63];
+
+	pos += testee04_compact(vin0, bytemask16(drop >>  0), output + pos);
+	pos += testee04_compact(vin1, bytemask16(drop >> 16), output + pos);
+	pos += testee04_compact(vin2, bytemask16(drop >> 32), output + pos);
+	pos += testee04_compact(vin3, bytemask16(drop >> 48), output + pos);
+	return pos;
+}
+
+// UTF-8 version of testee09, 64-batch
+template < class blank >
+PRUNER_TARGET_AVX2 inline size_t utf8_09(
+	uint8_t const* const input,
+	uint8_t* const output,
+	utf8_state& state) {
+	__m256i const vin0 = _mm256_loadu_si256(reinterpret_cast< __m256i const* >(input) + 0);
+	__m256i const vin1 = _mm256_loadu_si256(reinterpret_cast< __m256i const* >(input) + 1);
+
+	uint64_t const blanks =
+		uint64_t(uint32_t(_mm256_movemask_epi8(blank::mask(vin0)))) |
+		uint64_t(uint32_t(_mm256_movemask_epi8(blank::mask(vin1)))) << 32;
+	uint64_t const high =
+		uint64_t(uint32_t(_mm256_movemask_epi8(vin0))) |
+		uint64_t(uint32_t(_mm256_movemask_epi8(vin1))) << 32;
+
+	uint64_t drop = blanks;
+	size_t pos = 0;
+
+	if (high != 0 || state.cont != 0 || state.held_len != 0) {
+		__m256i const prev = _mm256_inserti128_si256(_mm256_setzero_si256(),
+			_mm_slli_si128(_mm_cvtsi32_si128(state.last), 15), 1);
+		utf8_bitmaps b = { high, 0, 0, 0, 0, 0, 0 };
+
+		utf8_classify(prev, vin0, vin1, 0, b);
+		utf8_classify(vin0, vin1, _mm256_setzero_si256(), 32, b);
+
+		drop = utf8_block(input, output, pos, blanks, b, state);
+	}
+	else
+		state.last = input[63];
+
+	pos += testee09_compact(vin0, bytemask32(drop), output + pos);
+	pos += testee09_compact(vin1, bytemask32(drop >> 32), output + pos);
+	return pos;
+}
+
+// UTF-8 version of testee10, 64-batch; with the classes in mask registers, the chars before and after are a shift of
+// the bitmaps away
+template < class blank >
+PRUNER_TARGET_AVX512VBMI2 inline size_t utf8_10(
+	uint8_t const* const input,
+	uint8_t* const output,
+	utf8_state& state) {
+	__m512i const vin = _mm512_loadu_si512(input);
+
+	uint64_t const blanks = ~blank::keep(vin);
+	uint64_t const high = _mm512_movepi8_mask(vin);
+
+	uint64_t drop = blanks;
+	size_t pos = 0;
+
+	if (high != 0 || state.cont != 0 || state.held_len != 0) {
+#define EQ(c) uint64_t(_mm512_cmpeq_epi8_mask(vin, _mm512_set1_epi8(char(c))))
+#define LT(c) uint64_t(_mm512_mask_cmplt_epu8_mask(high, vin, _mm512_set1_epi8(char(c))))
+#define GE(c) uint64_t(_mm512_cmpge_epu8_mask(vin, _mm512_set1_epi8(char(c))))
+#define AFTER(m, c) ((m) << 1 | (state.last == (c) ? 1 : 0))
+
+		uint64_t const x80 = EQ(0x80);
+		utf8_bitmaps b;
+		b.high = high;
+		b.cont = LT(0xc0);
+		b.lead3 = GE(0xe0);
+		b.lead4 = GE(0xf0);
+
+		// C0, C1 and F5 to FF; E0 and F0 leading overlong forms, ED surrogates, F4 code points past U+10FFFF
+		b.bad = EQ(0xc0) | EQ(0xc1) | GE(0xf5) |
+			(AFTER(EQ(0xe0), 0xe0) & LT(0xa0)) | (AFTER(EQ(0xed), 0xed) & GE(0xa0)) |
+			(AFTER(EQ(0xf0), 0xf0) & LT(0x90)) | (AFTER(EQ(0xf4), 0xf4) & GE(0x90));
+
+		b.start2 = EQ(0xc2) & (EQ(0x85) | EQ(0xa0)) >> 1;
+		b.start3 = (EQ(0xe1) & EQ(0x9a) >> 1 & x80 >> 2) | (EQ(0xe3) & x80 >> 1 & x80 >> 2) |
+			(EQ(0xe2) & ((x80 >> 1 & (LT(0x8b) | EQ(0xa8) | EQ(0xa9) | EQ(0xaf)) >> 2) | (EQ(0x81) >> 1 & EQ(0x9f) >> 2)));
+
+#undef AFTER
+#undef GE
+#undef LT
+#undef EQ
+		drop = utf8_block(input, output, pos, blanks, b, state);
+	}
+	else
+		state.last = input[63];
+
+	__mmask64 const keep = ~drop;
+
+	_mm512_storeu_si512(output + pos, _mm512_maskz_compress_epi8(keep, vin));
+	return pos + __builtin_popcountll(keep);
+}
+
+#endif
+
+// Drive a batch testee over an entire buffer, chaining the output offsets between batches. A batch never emits more
+// chars than it consumes, so with cap no less than len the garbage written past the count of any full batch stays
+// within len bytes of dst; with a lesser cap, batches that could write past it go through a local batch. The sub-batch
+// tail is padded with ' ' in a local batch, and only its non-blanks are copied out -- should the testee's predicate
+// keep ' ', the padding comes out last, and is left out. Always inlined, so that it gets built for the ISA extensions
+// of its caller, and can inline the testee in turn.
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank = blank_threshold<> >
+__attribute__ ((always_inline)) inline size_t prune_batches(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const cap) {
+
+	size_t i = 0, pos = 0;
+	for (; i + batch <= len && pos + batch <= cap; i += batch)
+		pos += testee(src + i, dst + pos);
+
+	uint8_t tail_in[batch] __attribute__ ((aligned(64)));
+	uint8_t tail_out[batch] __attribute__ ((aligned(64)));
+
+	for (; i + batch <= len; i += batch) {
+		size_t const batch_len = testee(src + i, tail_out);
+		memcpy(dst + pos, tail_out, batch_len);
+		pos += batch_len;
+	}
+
+	if (i < len) {
+		memset(tail_in, ' ', batch);
+		memcpy(tail_in, src + i, len - i);
+
+		size_t const tail_len = testee(tail_in, tail_out) - (blank::scalar(' ') ? 0 : batch - (len - i));
+		memcpy(dst + pos, tail_out, tail_len);
+		pos += tail_len;
+	}
+	return pos;
+}
+
+#if __x86_64__ || __i386__
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_SSSE3 size_t prune_batches_ssse3(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const cap) {
+
+	return prune_batches< batch, testee, blank >(src, len, dst, cap);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_AVX2 size_t prune_batches_avx2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const cap) {
+
+	return prune_batches< batch, testee, blank >(src, len, dst, cap);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_AVX512VBMI2 size_t prune_batches_avx512vbmi2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const cap) {
+
+	return prune_batches< batch, testee, blank >(src, len, dst, cap);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_SSE2 size_t prune_batches_sse2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const cap) {
+
+	return prune_batches< batch, testee, blank >(src, len, dst, cap);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_BMI2 size_t prune_batches_bmi2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const cap) {
+
+	return prune_batches< batch, testee, blank >(src, len, dst, cap);
+}
+
+#endif
+// Streaming: for outputs too big to be read back from the caches, the stores of the pruners proper only evict what is
+// of use, and cost a read for ownership of each line besides. So the batches get pruned into a staging buffer that
+// stays in L1, and its full cache lines go out with non-temporal stores, past the caches, with the input prefetched a
+// given distance ahead. The staging buffer keeps the alignment of dst, so all but the first line and the last are
+// whole lines of dst.
+size_t const stream_stage = 4096;
+
+// store a line of the staging buffer to a 64-aligned line of dst, past the caches where the target allows
+inline void stream_line(
+	uint8_t* const dst,
+	uint8_t const* const line) {
+
+#if __aarch64__
+	uint8x16_t const v0 = vld1q_u8(line);
+	uint8x16_t const v1 = vld1q_u8(line + 16);
+	uint8x16_t const v2 = vld1q_u8(line + 32);
+	uint8x16_t const v3 = vld1q_u8(line + 48);
+
+	asm volatile ("stnp %q0, %q1, [%2]" : : "w" (v0), "w" (v1), "r" (dst) : "memory");
+	asm volatile ("stnp %q0, %q1, [%2, #32]" : : "w" (v2), "w" (v3), "r" (dst) : "memory");
+
+#elif __SSE2__
+	for (size_t i = 0; i < 64; i += 16)
+		_mm_stream_si128(reinterpret_cast< __m128i* >(dst + i),
+			_mm_load_si128(reinterpret_cast< __m128i const* >(line + i)));
+
+#else
+	memcpy(dst, line, 64);
+
+#endif
+}
+
+// Drive a batch testee over an entire buffer through the staging buffer, prefetching 'prefetch' chars ahead unless 0;
+// returns the count of chars written, and writes nothing else; dst must have room for len chars, and must not overlap
+// src. The sub-batch tail goes char by char.
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+__attribute__ ((always_inline)) inline size_t stream_batches(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const prefetch) {
+
+	alignas(64) uint8_t stage[stream_stage + 64];
+	size_t const skip = uintptr_t(dst) % 64;
+
+	// stage[i] goes to line[i]; the chars of stage[0, lead) are not ours
+	uint8_t* line = dst - skip;
+	size_t lead = skip;
+	size_t fill = skip;
+	size_t i = 0;
+
+	for (; i + batch <= len; i += batch) {
+		if (prefetch != 0 && i % 64 < batch)
+			__builtin_prefetch(src + i + prefetch, 0, 0);
+
+		fill += testee(src + i, stage + fill);
+
+		if (fill >= stream_stage) {
+			size_t const full = fill / 64 * 64;
+			size_t j = 0;
+
+			if (lead != 0) {
+				memcpy(line + lead, stage + lead, 64 - lead);
+				lead = 0;
+				j = 64;
+			}
+			for (; j < full; j += 64)
+				stream_line(line + j, stage + j);
+
+			memcpy(stage, stage + full, fill - full);
+			line += full;
+			fill -= full;
+		}
+	}
+
+	for (; i < len; ++i) {
+		uint8_t const c = src[i];
+		stage[fill] = c;
+		fill += blank::scalar(c) ? 0 : 1;
+	}
+
+	memcpy(line + lead, stage + lead, fill - lead);
+#if __SSE2__
+	_mm_sfence();
+#endif
+	return size_t(line - dst) + fill;
+}
+
+#if __x86_64__ || __i386__
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_SSE2 size_t stream_batches_sse2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const prefetch) {
+
+	return stream_batches< batch, testee, blank >(src, len, dst, prefetch);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_SSSE3 size_t stream_batches_ssse3(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const prefetch) {
+
+	return stream_batches< batch, testee, blank >(src, len, dst, prefetch);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_AVX2 size_t stream_batches_avx2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const prefetch) {
+
+	return stream_batches< batch, testee, blank >(src, len, dst, prefetch);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_AVX512VBMI2 size_t stream_batches_avx512vbmi2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const prefetch) {
+
+	return stream_batches< batch, testee, blank >(src, len, dst, prefetch);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_BMI2 size_t stream_batches_bmi2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const prefetch) {
+
+	return stream_batches< batch, testee, blank >(src, len, dst, prefetch);
+}
+
+#endif
+// Batches of short strings -- fields, cells, tags -- each pruned into the output right after the previous one. A
+// string is its full batches, then its tail, padded with ' ' in a local batch and pruned into the output as is: the
+// garbage past its count gets overwritten by the next string, and the last string of all needs a batch of room past
+// the total of the lengths.
+struct prune_view {
+	uint8_t const* data;
+	size_t len;
+};
+
+// Drive a batch testee over n strings, writing all of their non-blanks to dst one string after the other; the view of
+// each in dst goes to the same index of results; returns the count of chars written. dst must have room for the sum
+// of the lengths, and a batch besides.
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+__attribute__ ((always_inline)) inline size_t prune_views(
+	prune_view const* const in,
+	size_t const n,
+	uint8_t* const dst,
+	prune_view* const results) {
+
+	uint8_t tail_in[batch] __attribute__ ((aligned(64)));
+	size_t pos = 0;
+
+	for (size_t s = 0; s < n; ++s) {
+		uint8_t const* const src = in[s].data;
+		size_t const len = in[s].len;
+		size_t const start = pos;
+		size_t i = 0;
+
+		for (; i + batch <= len; i += batch)
+			pos += testee(src + i, dst + pos);
+
+		if (i < len) {
+			memset(tail_in, ' ', batch);
+			memcpy(tail_in, src + i, len - i);
+			pos += testee(tail_in, dst + pos) - (blank::scalar(' ') ? 0 : batch - (len - i));
+		}
+
+		results[s].data = dst + start;
+		results[s].len = pos - start;
+	}
+	return pos;
+}
+
+#if __x86_64__ || __i386__
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_SSE2 size_t prune_views_sse2(
+	prune_view const* const in,
+	size_t const n,
+	uint8_t* const dst,
+	prune_view* const results) {
+
+	return prune_views< batch, testee, blank >(in, n, dst, results);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_SSSE3 size_t prune_views_ssse3(
+	prune_view const* const in,
+	size_t const n,
+	uint8_t* const dst,
+	prune_view* const results) {
+
+	return prune_views< batch, testee, blank >(in, n, dst, results);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_AVX2 size_t prune_views_avx2(
+	prune_view const* const in,
+	size_t const n,
+	uint8_t* const dst,
+	prune_view* const results) {
+
+	return prune_views< batch, testee, blank >(in, n, dst, results);
+}
+
+#if __x86_64__
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*), class blank >
+PRUNER_TARGET_BMI2 size_t prune_views_bmi2(
+	prune_view const* const in,
+	size_t const n,
+	uint8_t* const dst,
+	prune_view* const results) {
+
+	return prune_views< batch, testee, blank >(in, n, dst, results);
+}
+
+#endif
+// prune_views() over testee10, the tail of each string taken by a masked load, with ' ' in the lanes past it -- no
+// memcpy, and no read past the string
+template < class blank >
+PRUNER_TARGET_AVX512VBMI2 size_t prune_views10(
+	prune_view const* const in,
+	size_t const n,
+	uint8_t* const dst,
+	prune_view* const results) {
+
+	uint8_t tail_in[64] __attribute__ ((aligned(64)));
+	size_t pos = 0;
+
+	for (size_t s = 0; s < n; ++s) {
+		uint8_t const* const src = in[s].data;
+		size_t const len = in[s].len;
+		size_t const start = pos;
+		size_t i = 0;
+
+		for (; i + 64 <= len; i += 64)
+			pos += testee10< blank >(src + i, dst + pos);
+
+		if (i < len) {
+			__mmask64 const tail = (uint64_t(1) << (len - i)) - 1;
+
+			_mm512_store_si512(tail_in, _mm512_mask_loadu_epi8(_mm512_set1_epi8(' '), tail, src + i));
+			pos += testee10< blank >(tail_in, dst + pos) - (blank::scalar(' ') ? 0 : 64 - (len - i));
+		}
+
+		results[s].data = dst + start;
+		results[s].len = pos - start;
+	}
+	return pos;
+}
+
+#endif
+// Drive a collapse testee over an entire buffer, as prune_batches() does a batch testee, carrying the run of blanks
+// from batch to batch; dst must have room for len chars. The sub-batch tail is padded with ' ': past a non-blank, the
+// first char of the padding comes out last, and is left out -- as is all of the padding, should the predicate keep ' '.
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*, bool&), class blank >
+__attribute__ ((always_inline)) inline size_t collapse_batches(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	bool& run) {
+
+	size_t i = 0, pos = 0;
+	bool carry = run;
+	for (; i + batch <= len; i += batch)
+		pos += testee(src + i, dst + pos, carry);
+
+	if (i < len) {
+		uint8_t tail_in[batch] __attribute__ ((aligned(64)));
+		uint8_t tail_out[batch] __attribute__ ((aligned(64)));
+
+		memset(tail_in, ' ', batch);
+		memcpy(tail_in, src + i, len - i);
+
+		bool const last = blank::scalar(src[len - 1]);
+		size_t const pad = blank::scalar(' ') ? (last ? 0 : 1) : batch - (len - i);
+		size_t const tail_len = testee(tail_in, tail_out, carry) - pad;
+
+		memcpy(dst + pos, tail_out, tail_len);
+		pos += tail_len;
+		carry = last;
+	}
+
+	run = carry;
+	return pos;
+}
+
+#if __x86_64__ || __i386__
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*, bool&), class blank >
+PRUNER_TARGET_SSSE3 size_t collapse_batches_ssse3(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	bool& run) {
+
+	return collapse_batches< batch, testee, blank >(src, len, dst, run);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*, bool&), class blank >
+PRUNER_TARGET_AVX2 size_t collapse_batches_avx2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	bool& run) {
+
+	return collapse_batches< batch, testee, blank >(src, len, dst, run);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*, bool&), class blank >
+PRUNER_TARGET_AVX512VBMI2 size_t collapse_batches_avx512vbmi2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	bool& run) {
+
+	return collapse_batches< batch, testee, blank >(src, len, dst, run);
+}
+
+#endif
+// Drive a quote-aware testee over an entire buffer in 64-char blocks, carrying the quote state from block to block;
+// dst must have room for len chars. The sub-block tail goes through the scalar version.
+template < size_t (& testee)(uint8_t const*, uint8_t*, quote_state&), class blank, bool escapes >
+__attribute__ ((always_inline)) inline size_t quoted_batches(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	quote_state& state) {
+
+	size_t i = 0, pos = 0;
+	for (; i + 64 <= len; i += 64)
+		pos += testee(src + i, dst + pos, state);
+
+	return pos + quoted00< blank, escapes >(src + i, len - i, dst + pos, state);
+}
+
+#if __x86_64__ || __i386__
+template < size_t (& testee)(uint8_t const*, uint8_t*, quote_state&), class blank, bool escapes >
+PRUNER_TARGET_SSSE3 size_t quoted_batches_ssse3(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	quote_state& state) {
+
+	return quoted_batches< testee, blank, escapes >(src, len, dst, state);
+}
+
+template < size_t (& testee)(uint8_t const*, uint8_t*, quote_state&), class blank, bool escapes >
+PRUNER_TARGET_AVX2 size_t quoted_batches_avx2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	quote_state& state) {
+
+	return quoted_batches< testee, blank, escapes >(src, len, dst, state);
+}
+
+template < size_t (& testee)(uint8_t const*, uint8_t*, quote_state&), class blank, bool escapes >
+PRUNER_TARGET_AVX512VBMI2 size_t quoted_batches_avx512vbmi2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	quote_state& state) {
+
+	return quoted_batches< testee, blank, escapes >(src, len, dst, state);
+}
+
+#endif
+// Drive an adaptive testee over an entire buffer in 64-char blocks, as prune_batches() does a batch testee; dst must
+// have room for len chars. The counters accumulate in a local copy, so that they can live in registers.
+template < size_t (& testee)(uint8_t const*, uint8_t*, prune_paths&), class blank >
+__attribute__ ((always_inline)) inline size_t adaptive_batches(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	prune_paths& paths) {
+
+	prune_paths counts = paths;
+	size_t i = 0, pos = 0;
+	for (; i + 64 <= len; i += 64)
+		pos += testee(src + i, dst + pos, counts);
+
+	if (i < len) {
+		uint8_t tail_in[64] __attribute__ ((aligned(64)));
+		uint8_t tail_out[64] __attribute__ ((aligned(64)));
+
+		memset(tail_in, ' ', 64);
+		memcpy(tail_in, src + i, len - i);
+
+		size_t const tail_len = testee(tail_in, tail_out, counts) - (blank::scalar(' ') ? 0 : 64 - (len - i));
+		memcpy(dst + pos, tail_out, tail_len);
+		pos += tail_len;
+	}
+
+	paths = counts;
+	return pos;
+}
+
+#if __x86_64__ || __i386__
+template < size_t (& testee)(uint8_t const*, uint8_t*, prune_paths&), class blank >
+PRUNER_TARGET_SSSE3 size_t adaptive_batches_ssse3(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	prune_paths& paths) {
+
+	return adaptive_batches< testee, blank >(src, len, dst, paths);
+}
+
+template < size_t (& testee)(uint8_t const*, uint8_t*, prune_paths&), class blank >
+PRUNER_TARGET_AVX2 size_t adaptive_batches_avx2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	prune_paths& paths) {
+
+	return adaptive_batches< testee, blank >(src, len, dst, paths);
+}
+
+template < size_t (& testee)(uint8_t const*, uint8_t*, prune_paths&), class blank >
+PRUNER_TARGET_AVX512VBMI2 size_t adaptive_batches_avx512vbmi2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	prune_paths& paths) {
+
+	return adaptive_batches< testee, blank >(src, len, dst, paths);
+}
+
+#endif
+// Drive a position testee over an entire buffer, as prune_batches() does a batch testee with no cap; dst must have
+// room for len chars, and positions for len offsets
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*, uint32_t*, uint32_t), class blank >
+__attribute__ ((always_inline)) inline size_t positions_batches(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	uint32_t* const positions) {
+
+	size_t i = 0, pos = 0;
+	for (; i + batch <= len; i += batch)
+		pos += testee(src + i, dst + pos, positions + pos, uint32_t(i));
+
+	if (i < len) {
+		uint8_t tail_in[batch] __attribute__ ((aligned(64)));
+		uint8_t tail_out[batch] __attribute__ ((aligned(64)));
+		uint32_t tail_positions[batch] __attribute__ ((aligned(64)));
+
+		memset(tail_in, ' ', batch);
+		memcpy(tail_in, src + i, len - i);
+
+		size_t const tail_len = testee(tail_in, tail_out, tail_positions, uint32_t(i)) -
+			(blank::scalar(' ') ? 0 : batch - (len - i));
+		memcpy(dst + pos, tail_out, tail_len);
+		memcpy(positions + pos, tail_positions, tail_len * sizeof(uint32_t));
+		pos += tail_len;
+	}
+	return pos;
+}
+
+#if __x86_64__ || __i386__
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*, uint32_t*, uint32_t), class blank >
+PRUNER_TARGET_SSSE3 size_t positions_batches_ssse3(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	uint32_t* const positions) {
+
+	return positions_batches< batch, testee, blank >(src, len, dst, positions);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*, uint32_t*, uint32_t), class blank >
+PRUNER_TARGET_AVX2 size_t positions_batches_avx2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	uint32_t* const positions) {
+
+	return positions_batches< batch, testee, blank >(src, len, dst, positions);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*, uint32_t*, uint32_t), class blank >
+PRUNER_TARGET_AVX512VBMI2 size_t positions_batches_avx512vbmi2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	uint32_t* const positions) {
+
+	return positions_batches< batch, testee, blank >(src, len, dst, positions);
+}
+
+#endif
+// Drive a UTF-8 testee over an entire buffer in 64-char blocks, carrying the state from block to block; dst must have
+// room for len chars, and the chars held back from the previous buffer. The sub-block tail goes through the scalar
+// version.
+template < size_t (& testee)(uint8_t const*, uint8_t*, utf8_state&), class blank >
+__attribute__ ((always_inline)) inline size_t utf8_batches(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	utf8_state& state) {
+
+	size_t i = 0, pos = 0;
+	for (; i + 64 <= len; i += 64)
+		pos += testee(src + i, dst + pos, state);
+
+	return pos + utf8_00< blank >(src + i, len - i, dst + pos, state);
+}
+
+#if __x86_64__ || __i386__
+template < size_t (& testee)(uint8_t const*, uint8_t*, utf8_state&), class blank >
+PRUNER_TARGET_SSSE3 size_t utf8_batches_ssse3(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	utf8_state& state) {
+
+	return utf8_batches< testee, blank >(src, len, dst, state);
+}
+
+template < size_t (& testee)(uint8_t const*, uint8_t*, utf8_state&), class blank >
+PRUNER_TARGET_AVX2 size_t utf8_batches_avx2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	utf8_state& state) {
+
+	return utf8_batches< testee, blank >(src, len, dst, state);
+}
+
+template < size_t (& testee)(uint8_t const*, uint8_t*, utf8_state&), class blank >
+PRUNER_TARGET_AVX512VBMI2 size_t utf8_batches_avx512vbmi2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	utf8_state& state) {
+
+	return utf8_batches< testee, blank >(src, len, dst, state);
+}
+
+#endif
+// pruners to pick from at runtime; which of them are available depends on both the target and the CPU at hand
+enum prune_kernel {
+	kernel_testee00,     // scalar
+	kernel_testee04,     // amd64, SSSE3 + POPCNT
+	kernel_testee05,     // amd64, SSSE3 + POPCNT
+	kernel_testee06,     // arm64, ASIMD
+	kernel_testee07,     // arm64, ASIMD; tuned for same latency of q-form and d-form ops
+	kernel_testee07_a72, // arm64, ASIMD; tuned for cortex-a57/a72
+	kernel_testee08,     // arm64, SVE512; only when built for SVE
+	kernel_testee09,     // amd64, AVX2 + POPCNT
+	kernel_testee10,     // amd64, AVX-512 VBMI2
+	kernel_testee14,     // amd64, SSSE3 + POPCNT; arm64, ASIMD; 1 MiB lookup table, for a core of its own
+	kernel_testee15,     // amd64 (64-bit only), SSSE3 + POPCNT + BMI2
+	kernel_testee16,     // amd64, SSE2; default predicate only
+	kernel_testee17,     // any, 64-bit SWAR; default predicate only
+	kernel_count
+};
+
+inline char const* prune_kernel_name(
+	prune_kernel const kernel) {
+
+	static char const* const name[kernel_count] = {
+		"testee00",
+		"testee04",
+		"testee05",
+		"testee06",
+		"testee07",
+		"testee07_a72",
+		"testee08",
+		"testee09",
+		"testee10",
+		"testee14",
+		"testee15",
+		"testee16",
+		"testee17"
+	};
+	return size_t(kernel) < size_t(kernel_count) ? name[kernel] : "unknown";
+}
+
+// can the CPU at hand run the given pruner
+inline bool prune_supported(
+	prune_kernel const kernel) {
+
+	switch (kernel) {
+	case kernel_testee00:
+	case kernel_testee17:
+		return true;
+
+#if __aarch64__
+	case kernel_testee06:
+	case kernel_testee07:
+	case kernel_testee07_a72:
+	case kernel_testee14:
+#if __linux__
+		return getauxval(AT_HWCAP) & HWCAP_ASIMD;
+#else
+		return true;
+#endif
+
+#if defined(__ARM_FEATURE_SVE)
+	case kernel_testee08:
+		return svcntb() == 64; // testee08 assumes exactly sve512
+
+#endif
+#elif __x86_64__ || __i386__
+	case kernel_testee04:
+	case kernel_testee05:
+	case kernel_testee14:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("popcnt");
+
+	case kernel_testee09:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+
+	case kernel_testee10:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vbmi") &&
+			__builtin_cpu_supports("avx512vbmi2") && __builtin_cpu_supports("popcnt");
+
+#if __x86_64__
+	case kernel_testee15:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("popcnt") && __builtin_cpu_supports("bmi2");
+
+#endif
+	case kernel_testee16:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("sse2");
+
+#endif
+	default:
+		return false;
+	}
+}
+
+// probe the CPU at hand for its fastest pruner, as per the measurements in README.md; one that owns its core, and the
+// caches with it, can afford the lookup-table pruner on amd64
+inline prune_kernel prune_select(
+	bool const owns_core = PRUNER_OWNS_CORE) {
+
+#if __aarch64__
+	// no measurements of testee14 on arm64 yet
+	(void) owns_core;
+
+	if (!prune_supported(kernel_testee07))
+		return kernel_testee00;
+
+#if __linux__ && defined(HWCAP_CPUID)
+	// with HWCAP_CPUID the kernel emulates EL0 reads of MIDR_EL1; on big.LITTLE parts that gives us the core we happen
+	// to run on at the moment, which is as good as it gets without pinning
+	if (getauxval(AT_HWCAP) & HWCAP_CPUID) {
+		uint64_t midr;
+		asm volatile ("mrs %0, MIDR_EL1" : "=r" (midr));
+
+		uint32_t const implementer = midr >> 24 & 0xff;
+		uint32_t const part = midr >> 4 & 0xfff;
+
+		// cortex-a57, cortex-a72: q-form permutes and pairwise adds come at such latency that the scalar pruner does
+		// better -- 1.3805 clocks/char against 1.4603 for testee07; testee07_a72 stays on offer by request
+		if (implementer == 0x41 && (part == 0xd07 || part == 0xd08))
+			return kernel_testee00;
+	}
+
+#endif
+	return kernel_testee07;
+
+#elif __x86_64__ || __i386__
+	__builtin_cpu_init();
+
+	if (prune_supported(kernel_testee10))
+		return kernel_testee10;
+
+#if __x86_64__
+	// pext does 8 chars a clock and beats testee09, and testee14 with it, unless in microcode, as on zen1 and zen2
+	if (prune_supported(kernel_testee15) && !__builtin_cpu_is("znver1") && !__builtin_cpu_is("znver2"))
+		return kernel_testee15;
+
+#endif
+	// with its table warm testee14 matches testee09, and does twice as well as testee04; with it cold, it does worse
+	// than either
+	if (owns_core && prune_supported(kernel_testee14) && !__builtin_cpu_is("btver1"))
+		return kernel_testee14;
+
+	// zen1 splits 256-bit ops in two halves and does better with SSSE3, even more so than at AVX2-128
+	if (prune_supported(kernel_testee09) && !__builtin_cpu_is("znver1"))
+		return kernel_testee09;
+
+	// bobcat suffers death by popcnt, and is better off without it
+	if (prune_supported(kernel_testee04) && !__builtin_cpu_is("btver1"))
+		return kernel_testee04;
+
+	// no SSSE3, e.g. on virtualized hosts that mask it; bobcat stays on testee00, the measured best there, as testee16
+	// never was
+	if (prune_supported(kernel_testee16) && !__builtin_cpu_is("btver1"))
+		return kernel_testee16;
+
+	return kernel_testee00;
+
+#else
+	(void) owns_core;
+	return kernel_testee00;
+
+#endif
+}
+
+// prune all blanks from src[0, len) into dst using the given pruner, which the CPU must support; returns the count of
+// non-blanks, which must not exceed cap; nothing is written past the lesser of dst + len and dst + cap
+template < class blank = blank_threshold<> >
+inline size_t prune_bounded(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const cap,
+	prune_kernel const kernel) {
+
+	switch (kernel) {
+#if __aarch64__
+	case kernel_testee06:
+		return prune_batches< 16, testee06< blank >, blank >(src, len, dst, cap);
+
+	case kernel_testee07:
+		return prune_batches< 32, testee07< true, blank >, blank >(src, len, dst, cap);
+
+	case kernel_testee07_a72:
+		return prune_batches< 32, testee07< false, blank >, blank >(src, len, dst, cap);
+
+	case kernel_testee14:
+		return prune_batches< 16, testee14< 16, blank >, blank >(src, len, dst, cap);
+
+#if defined(__ARM_FEATURE_SVE)
+	// testee08 knows just the default predicate; testee07 stands in for it with the rest
+	case kernel_testee08:
+		if (!std::is_same< blank, blank_threshold<> >::value)
+			return prune_batches< 32, testee07< true, blank >, blank >(src, len, dst, cap);
+
+		return prune_batches< 64, testee08 >(src, len, dst, cap);
+
+#endif
+#elif __x86_64__ || __i386__
+	case kernel_testee04:
+		return prune_batches_ssse3< 16, testee04< blank >, blank >(src, len, dst, cap);
+
+	case kernel_testee05:
+		return prune_batches_ssse3< 16, testee05< blank >, blank >(src, len, dst, cap);
+
+	case kernel_testee09:
+		return prune_batches_avx2< 32, testee09< blank >, blank >(src, len, dst, cap);
+
+	case kernel_testee10:
+		return prune_batches_avx512vbmi2< 64, testee10< blank >, blank >(src, len, dst, cap);
+
+	case kernel_testee14:
+		return prune_batches_ssse3< 16, testee14< 16, blank >, blank >(src, len, dst, cap);
+
+#if __x86_64__
+	case kernel_testee15:
+		return prune_batches_bmi2< 32, testee15< blank >, blank >(src, len, dst, cap);
+
+#endif
+	// testee16 knows just the default predicate; testee00 stands in for it with the rest
+	case kernel_testee16:
+		if (!std::is_same< blank, blank_threshold<> >::value)
+			return prune_batches< 16, testee00< blank >, blank >(src, len, dst, cap);
+
+		return prune_batches_sse2< 16, testee16, blank >(src, len, dst, cap);
+
+#endif
+	// as does testee17
+	case kernel_testee17:
+		if (!std::is_same< blank, blank_threshold<> >::value)
+			return prune_batches< 16, testee00< blank >, blank >(src, len, dst, cap);
+
+		return prune_batches< 16, testee17, blank >(src, len, dst, cap);
+
+	default:
+		return prune_batches< 16, testee00< blank >, blank >(src, len, dst, cap);
+	}
+}
+
+// prune all blanks from src[0, len) into dst using the given pruner, which the CPU must support; returns the count of
+// non-blanks; dst must have room for len chars
+template < class blank = blank_threshold<> >
+inline size_t prune(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	prune_kernel const kernel) {
+
+	return prune_bounded< blank >(src, len, dst, len, kernel);
+}
+
+// the fastest pruner for the CPU at hand, as probed on first use
+inline prune_kernel prune_default() {
+	static prune_kernel const kernel = prune_select();
+	return kernel;
+}
+
+// prune all blanks from src[0, len) into dst using the fastest pruner for the CPU at hand, as probed on first use;
+// returns the count of non-blanks; dst must have room for len chars; reentrant -- no state is kept between calls. The
+// blanks are those of the given predicate, e.g. prune< blank_set< '\r', '\n' > >(src, len, dst)
+template < class blank = blank_threshold<> >
+inline size_t prune(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst) {
+
+	return prune< blank >(src, len, dst, prune_default());
+}
+
+// Prune all blanks from buf[0, len) in place, using the given pruner, which the CPU must support; returns the count of
+// non-blanks, now at the start of buf; what is left past them is garbage. The output position never runs ahead of the
+// input position, so the stores of a batch -- up to a full batch from the output position, overlapping or not -- only
+// ever land on chars already read; the sub-batch tail is read out to a local batch before any of it gets written.
+template < class blank = blank_threshold<> >
+inline size_t prune_in_place(
+	uint8_t* const buf,
+	size_t const len,
+	prune_kernel const kernel) {
+
+	return prune_bounded< blank >(buf, len, buf, len, kernel);
+}
+
+// prune_in_place() using the fastest pruner for the CPU at hand
+template < class blank = blank_threshold<> >
+inline size_t prune_in_place(
+	uint8_t* const buf,
+	size_t const len) {
+
+	return prune_in_place< blank >(buf, len, prune_default());
+}
+
+// Prune all blanks from src[0, len) into dst as prune() does, for outputs that will not be read back soon -- buffers
+// past the size of the last-level cache: dst gets written past the caches, in whole lines, and src gets prefetched
+// 'prefetch' chars ahead. Returns the count of non-blanks; dst must have room for len chars, must not overlap src, and
+// gets nothing written past the non-blanks.
+template < class blank = blank_threshold<> >
+inline size_t prune_stream(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	prune_kernel const kernel,
+	size_t const prefetch = PRUNER_PREFETCH_DISTANCE) {
+
+	switch (kernel) {
+#if __aarch64__
+	case kernel_testee06:
+		return stream_batches< 16, testee06< blank >, blank >(src, len, dst, prefetch);
+
+	case kernel_testee07:
+	case kernel_testee08:
+		return stream_batches< 32, testee07< true, blank >, blank >(src, len, dst, prefetch);
+
+	case kernel_testee07_a72:
+		return stream_batches< 32, testee07< false, blank >, blank >(src, len, dst, prefetch);
+
+	case kernel_testee14:
+		return stream_batches< 16, testee14< 16, blank >, blank >(src, len, dst, prefetch);
+
+#elif __x86_64__ || __i386__
+	case kernel_testee04:
+		return stream_batches_ssse3< 16, testee04< blank >, blank >(src, len, dst, prefetch);
+
+	case kernel_testee05:
+		return stream_batches_ssse3< 16, testee05< blank >, blank >(src, len, dst, prefetch);
+
+	case kernel_testee09:
+		return stream_batches_avx2< 32, testee09< blank >, blank >(src, len, dst, prefetch);
+
+	case kernel_testee10:
+		return stream_batches_avx512vbmi2< 64, testee10< blank >, blank >(src, len, dst, prefetch);
+
+	case kernel_testee14:
+		return stream_batches_ssse3< 16, testee14< 16, blank >, blank >(src, len, dst, prefetch);
+
+#if __x86_64__
+	case kernel_testee15:
+		return stream_batches_bmi2< 32, testee15< blank >, blank >(src, len, dst, prefetch);
+
+#endif
+	case kernel_testee16:
+		if (!std::is_same< blank, blank_threshold<> >::value)
+			return stream_batches< 16, testee00< blank >, blank >(src, len, dst, prefetch);
+
+		return stream_batches_sse2< 16, testee16, blank >(src, len, dst, prefetch);
+
+#endif
+	case kernel_testee17:
+		if (!std::is_same< blank, blank_threshold<> >::value)
+			return stream_batches< 16, testee00< blank >, blank >(src, len, dst, prefetch);
+
+		return stream_batches< 16, testee17, blank >(src, len, dst, prefetch);
+
+	default:
+		return stream_batches< 16, testee00< blank >, blank >(src, len, dst, prefetch);
+	}
+}
+
+// prune_stream() using the fastest pruner for the CPU at hand
+template < class blank = blank_threshold<> >
+inline size_t prune_stream(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst) {
+
+	return prune_stream< blank >(src, len, dst, prune_default());
+}
+
+// Bump allocator for the output of prune_batch(): chunks of at least 'chunk' chars, which never move, so whatever got
+// allocated stays put until reset(). reset() keeps the chunks for reuse, and they are freed with the arena, so a
+// reused arena makes no heap allocations once it has grown to the size of the batches.
+struct prune_arena {
+	explicit prune_arena(
+		size_t const chunk = size_t(1) << 20) : chunk(chunk), current(0), used(0) {
+	}
+
+	// room for len contiguous chars
+	uint8_t* alloc(
+		size_t const len) {
+
+		while (current < chunks.size() && chunks[current].size() - used < len) {
+			++current;
+			used = 0;
+		}
+
+		if (current == chunks.size())
+			chunks.push_back(std::vector< uint8_t >(len > chunk ? len : chunk));
+
+		uint8_t* const ret = chunks[current].data() + used;
+		used += len;
+		return ret;
+	}
+
+	// give back the last len chars of the last allocation
+	void release(
+		size_t const len) {
+
+		used -= len;
+	}
+
+	void reset() {
+		current = 0;
+		used = 0;
+	}
+
+	size_t chunk;
+	std::vector< std::vector< uint8_t > > chunks;
+	size_t current; // chunk allocated from
+	size_t used;    // chars of it allocated
+};
+
+// Prune all blanks from each of n strings, using the given pruner, which the CPU must support, into a single run of
+// the arena -- the outputs one after the other, in order -- and write the view of each output to the same index of
+// results; returns the count of chars written. Short strings are the point, so the lookup-table pruner, whose table
+// would not stay in cache between them, gives way to the pruner of the same ISA extensions.
+template < class blank = blank_threshold<> >
+inline size_t prune_batch(
+	prune_view const* const in,
+	size_t const n,
+	prune_arena& out,
+	prune_view* const results,
+	prune_kernel const kernel) {
+
+	size_t total = 0;
+	for (size_t s = 0; s < n; ++s)
+		total += in[s].len;
+
+	// a batch of room past the last string, for the widest of the testees
+	uint8_t* const dst = out.alloc(total + 64);
+	size_t pos;
+
+	switch (kernel) {
+#if __aarch64__
+	case kernel_testee06:
+		pos = prune_views< 16, testee06< blank >, blank >(in, n, dst, results);
+		break;
+
+	case kernel_testee07:
+	case kernel_testee08:
+	case kernel_testee14:
+		pos = prune_views< 32, testee07< true, blank >, blank >(in, n, dst, results);
+		break;
+
+	case kernel_testee07_a72:
+		pos = prune_views< 32, testee07< false, blank >, blank >(in, n, dst, results);
+		break;
+
+#elif __x86_64__ || __i386__
+	case kernel_testee04:
+	case kernel_testee14:
+		pos = prune_views_ssse3< 16, testee04< blank >, blank >(in, n, dst, results);
+		break;
+
+	case kernel_testee09:
+		pos = prune_views_avx2< 32, testee09< blank >, blank >(in, n, dst, results);
+		break;
+
+	case kernel_testee10:
+		pos = prune_views10< blank >(in, n, dst, results);
+		break;
+
+#if __x86_64__
+	case kernel_testee15:
+		pos = prune_views_bmi2< 32, testee15< blank >, blank >(in, n, dst, results);
+		break;
+
+#endif
+	case kernel_testee05:
+		pos = prune_views_ssse3< 16, testee05< blank >, blank >(in, n, dst, results);
+		break;
+
+	case kernel_testee16:
+		if (!std::is_same< blank, blank_threshold<> >::value)
+			pos = prune_views< 16, testee00< blank >, blank >(in, n, dst, results);
+		else
+			pos = prune_views_sse2< 16, testee16, blank >(in, n, dst, results);
+		break;
+
+#endif
+	case kernel_testee17:
+		if (!std::is_same< blank, blank_threshold<> >::value)
+			pos = prune_views< 16, testee00< blank >, blank >(in, n, dst, results);
+		else
+			pos = prune_views< 16, testee17, blank >(in, n, dst, results);
+		break;
+
+	default:
+		pos = prune_views< 16, testee00< blank >, blank >(in, n, dst, results);
+		break;
+	}
+
+	out.release(total + 64 - pos);
+	return pos;
+}
+
+// prune_batch() using the fastest pruner for the CPU at hand
+template < class blank = blank_threshold<> >
+inline size_t prune_batch(
+	prune_view const* const in,
+	size_t const n,
+	prune_arena& out,
+	prune_view* const results) {
+
+	return prune_batch< blank >(in, n, out, results, prune_default());
+}
+
+// Collapse each run of blanks in src[0, len) into a single ' ', into dst, using the collapse version of the given
+// pruner, which the CPU must support; returns the count of chars written; dst must have room for len chars, and may
+// be src itself. 'run' tells whether the char before src was a blank, and is left telling whether the last char of
+// src was one, so that a stream can be collapsed buffer by buffer.
+template < class blank = blank_threshold<> >
+inline size_t prune_collapse(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	bool& run,
+	prune_kernel const kernel) {
+
+	switch (kernel) {
+#if __aarch64__
+	case kernel_testee06:
+	case kernel_testee07:
+	case kernel_testee08:
+	case kernel_testee14:
+		return collapse_batches< 32, collapse07< true, blank >, blank >(src, len, dst, run);
+
+	case kernel_testee07_a72:
+		return collapse_batches< 32, collapse07< false, blank >, blank >(src, len, dst, run);
+
+#elif __x86_64__ || __i386__
+	case kernel_testee04:
+	case kernel_testee05:
+	case kernel_testee14:
+	case kernel_testee15:
+		return collapse_batches_ssse3< 16, collapse04< blank >, blank >(src, len, dst, run);
+
+	case kernel_testee09:
+		return collapse_batches_avx2< 32, collapse09< blank >, blank >(src, len, dst, run);
+
+	case kernel_testee10:
+		return collapse_batches_avx512vbmi2< 64, collapse10< blank >, blank >(src, len, dst, run);
+
+#endif
+	default:
+		return collapse_batches< 16, collapse00< blank >, blank >(src, len, dst, run);
+	}
+}
+
+// prune_collapse() using the fastest pruner for the CPU at hand
+template < class blank = blank_threshold<> >
+inline size_t prune_collapse(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	bool& run) {
+
+	return prune_collapse< blank >(src, len, dst, run, prune_default());
+}
+
+// prune_collapse() of an entire text, e.g. a field to normalize before hashing; a leading run of blanks still comes
+// out as a single ' '
+template < class blank = blank_threshold<> >
+inline size_t prune_collapse(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst) {
+
+	bool run = false;
+	return prune_collapse< blank >(src, len, dst, run, prune_default());
+}
+
+// Prune the blanks outside of quoted strings from src[0, len) into dst, using the quote-aware version of the given
+// pruner, which the CPU must support; returns the count of chars written; dst must have room for len chars, and may be
+// src itself. With escapes, a backslash escapes the char that follows, as in JSON; without, as in CSV, a quote within
+// a string is doubled. The state carries over from call to call, so that a stream can go buffer by buffer; it starts
+// zeroed -- outside of any string.
+template < bool escapes, class blank = blank_threshold<> >
+inline size_t prune_quoted(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	quote_state& state,
+	prune_kernel const kernel) {
+
+	switch (kernel) {
+#if __aarch64__
+	case kernel_testee06:
+	case kernel_testee07:
+	case kernel_testee08:
+	case kernel_testee14:
+		return quoted_batches< quoted07< true, blank, escapes >, blank, escapes >(src, len, dst, state);
+
+	case kernel_testee07_a72:
+		return quoted_batches< quoted07< false, blank, escapes >, blank, escapes >(src, len, dst, state);
+
+#elif __x86_64__ || __i386__
+	case kernel_testee04:
+	case kernel_testee05:
+	case kernel_testee14:
+	case kernel_testee15:
+		return quoted_batches_ssse3< quoted04< blank, escapes >, blank, escapes >(src, len, dst, state);
+
+	case kernel_testee09:
+		return quoted_batches_avx2< quoted09< blank, escapes >, blank, escapes >(src, len, dst, state);
+
+	case kernel_testee10:
+		return quoted_batches_avx512vbmi2< quoted10< blank, escapes >, blank, escapes >(src, len, dst, state);
+
+#endif
+	default:
+		return quoted00< blank, escapes >(src, len, dst, state);
+	}
+}
+
+// prune_quoted() using the fastest pruner for the CPU at hand
+template < bool escapes, class blank = blank_threshold<> >
+inline size_t prune_quoted(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	quote_state& state) {
+
+	return prune_quoted< escapes, blank >(src, len, dst, state, prune_default());
+}
+
+// minify an entire JSON text: all blanks outside of strings go
+inline size_t prune_json(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst) {
+
+	quote_state state = { 0, 0 };
+	return prune_quoted< true >(src, len, dst, state);
+}
+
+// minify an entire CSV text: all blanks outside of quoted fields go, line breaks included -- for CSV with records
+// one per line, pass a predicate that keeps '\n', e.g. prune_quoted< false, blank_set< ' ', '\t', '\r' > >
+inline size_t prune_csv(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst) {
+
+	quote_state state = { 0, 0 };
+	return prune_quoted< false >(src, len, dst, state);
+}
+
+// Prune all blanks from src[0, len) into dst as prune() does, using the adaptive version of the given pruner, which
+// the CPU must support: blocks and batches without blanks are copied as they are, those of blanks alone skipped, and
+// only the rest compacted -- a win on inputs of long clean runs, a loss of a mispredicted branch here and there on the
+// rest. Returns the count of non-blanks; dst must have room for len chars, and may be src itself. The counts of the
+// paths taken add up in 'paths'; the scalar pruner leaves them be.
+template < class blank = blank_threshold<> >
+inline size_t prune_adaptive(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	prune_paths& paths,
+	prune_kernel const kernel) {
+
+	switch (kernel) {
+#if __aarch64__
+	case kernel_testee06:
+	case kernel_testee07:
+	case kernel_testee08:
+	case kernel_testee14:
+		return adaptive_batches< adaptive07< true, blank >, blank >(src, len, dst, paths);
+
+	case kernel_testee07_a72:
+		return adaptive_batches< adaptive07< false, blank >, blank >(src, len, dst, paths);
+
+#elif __x86_64__ || __i386__
+	case kernel_testee04:
+	case kernel_testee05:
+	case kernel_testee14:
+	case kernel_testee15:
+		return adaptive_batches_ssse3< adaptive04< blank >, blank >(src, len, dst, paths);
+
+	case kernel_testee09:
+		return adaptive_batches_avx2< adaptive09< blank >, blank >(src, len, dst, paths);
+
+	case kernel_testee10:
+		return adaptive_batches_avx512vbmi2< adaptive10< blank >, blank >(src, len, dst, paths);
+
+#endif
+	default:
+		return prune_batches< 16, testee00< blank >, blank >(src, len, dst, len);
+	}
+}
+
+// prune_adaptive() using the fastest pruner for the CPU at hand
+template < class blank = blank_threshold<> >
+inline size_t prune_adaptive(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	prune_paths& paths) {
+
+	return prune_adaptive< blank >(src, len, dst, paths, prune_default());
+}
+
+// prune_adaptive() without the counters
+template < class blank = blank_threshold<> >
+inline size_t prune_adaptive(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst) {
+
+	prune_paths paths = { 0, 0, 0, 0, 0 };
+	return prune_adaptive< blank >(src, len, dst, paths, prune_default());
+}
+
+// Prune all blanks from src[0, len) into dst as prune() does, using the position version of the given pruner, which
+// the CPU must support; alongside each char kept, write its offset in src to the same index of positions, so that
+// whatever is found in the pruned text can be traced back to the source. Returns the count of non-blanks; dst must
+// have room for len chars, and positions for len offsets. The offsets are 32-bit, so len must not exceed 4 GiB; a
+// larger input is up to the caller to split into chunks, the positions of each then being relative to its start.
+template < class blank = blank_threshold<> >
+inline size_t prune_positions(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	uint32_t* const positions,
+	prune_kernel const kernel) {
+
+	assert(uint64_t(len) <= uint64_t(1) << 32);
+
+	switch (kernel) {
+#if __aarch64__
+	case kernel_testee06:
+	case kernel_testee07:
+	case kernel_testee07_a72:
+	case kernel_testee08:
+	case kernel_testee14:
+		return positions_batches< 16, positions11< blank >, blank >(src, len, dst, positions);
+
+#elif __x86_64__ || __i386__
+	case kernel_testee04:
+	case kernel_testee05:
+	case kernel_testee14:
+	case kernel_testee15:
+		return positions_batches_ssse3< 16, positions11< blank >, blank >(src, len, dst, positions);
+
+	case kernel_testee09:
+		return positions_batches_avx2< 32, positions12< blank >, blank >(src, len, dst, positions);
+
+	case kernel_testee10:
+		return positions_batches_avx512vbmi2< 64, positions10< blank >, blank >(src, len, dst, positions);
+
+#endif
+	default:
+		return positions_batches< 16, positions00< blank >, blank >(src, len, dst, positions);
+	}
+}
+
+// prune_positions() using the fastest pruner for the CPU at hand
+template < class blank = blank_threshold<> >
+inline size_t prune_positions(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	uint32_t* const positions) {
+
+	return prune_positions< blank >(src, len, dst, positions, prune_default());
+}
+
+// Prune all blanks from UTF-8 src[0, len) into dst, using the UTF-8 version of the given pruner, which the CPU must
+// support: the blanks of the predicate among the ASCII chars, and the Unicode blanks past ASCII, all chars of each.
+// Returns the count of chars written; dst must have room for len chars, and the up to 2 chars held back from the
+// previous call. The state carries over from call to call, so that a stream can go buffer by buffer, split anywhere;
+// it starts zeroed, and prune_utf8_finish() ends the stream. Ill-formed UTF-8 gets pruned all the same, and leaves
+// state.error set.
+template < class blank = blank_threshold<> >
+inline size_t prune_utf8(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	utf8_state& state,
+	prune_kernel const kernel) {
+
+	switch (kernel) {
+#if __aarch64__
+	case kernel_testee06:
+	case kernel_testee07:
+	case kernel_testee08:
+	case kernel_testee14:
+		return utf8_batches< utf8_07< true, blank >, blank >(src, len, dst, state);
+
+	case kernel_testee07_a72:
+		return utf8_batches< utf8_07< false, blank >, blank >(src, len, dst, state);
+
+#elif __x86_64__ || __i386__
+	case kernel_testee04:
+	case kernel_testee05:
+	case kernel_testee14:
+	case kernel_testee15:
+		return utf8_batches_ssse3< utf8_04< blank >, blank >(src, len, dst, state);
+
+	case kernel_testee09:
+		return utf8_batches_avx2< utf8_09< blank >, blank >(src, len, dst, state);
+
+	case kernel_testee10:
+		return utf8_batches_avx512vbmi2< utf8_10< blank >, blank >(src, len, dst, state);
+
+#endif
+	default:
+		return utf8_00< blank >(src, len, dst, state);
+	}
+}
+
+// prune_utf8() using the fastest pruner for the CPU at hand
+template < class blank = blank_threshold<> >
+inline size_t prune_utf8(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	utf8_state& state) {
+
+	return prune_utf8< blank >(src, len, dst, state, prune_default());
+}
+
+// end a stream of prune_utf8(): writes the chars still held back to dst, and returns their count; tells whether the
+// stream was well-formed UTF-8
+inline size_t prune_utf8_finish(
+	uint8_t* const dst,
+	utf8_state& state,
+	bool& valid) {
+
+	size_t const held_len = utf8_finish(dst, state);
+	valid = state.error == 0;
+	return held_len;
+}
+
+// prune an entire UTF-8 text, telling whether it is well-formed, e.g. a field to trim of all kinds of spaces
+template < class blank = blank_threshold<> >
+inline size_t prune_utf8(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	bool& valid,
+	prune_kernel const kernel = prune_default()) {
+
+	utf8_state state = { 0, 0, 0, 0, 0 };
+	size_t const pos = prune_utf8< blank >(src, len, dst, state, kernel);
+	return pos + prune_utf8_finish(dst + pos, state, valid);
+}
+
+// Count and bitmap fronts: the compare and the movemask of the pruners proper, without the compaction -- the bitmap of
+// the blanks of 64 chars at a time, two such at a time
+#if __aarch64__
+template < class blank >
+inline uint64_t blanks64(
+	uint8_t const* const src) {
+
+	return bitmap64(
+		blank::mask(vld1q_u8(src + 0)), blank::mask(vld1q_u8(src + 16)),
+		blank::mask(vld1q_u8(src + 32)), blank::mask(vld1q_u8(src + 48)));
+}
+
+#elif __x86_64__ || __i386__
+// whether the 128-bit mask of a predicate takes no more than SSE2 -- the compares do, the nibble lookups do not
+template < class blank >
+struct blank_sse2 : std::false_type {
+};
+
+template < uint8_t threshold >
+struct blank_sse2< blank_threshold< threshold > > : std::true_type {
+};
+
+template < uint8_t... chars >
+struct blank_sse2< blank_set< chars... > > : std::true_type {
+};
+
+template < class blank >
+PRUNER_TARGET_SSE2 inline uint64_t blanks64_sse2(
+	uint8_t const* const src) {
+
+	__m128i const* const vsrc = reinterpret_cast< __m128i const* >(src);
+	return
+		uint64_t(uint32_t(_mm_movemask_epi8(blank::mask(_mm_loadu_si128(vsrc + 0))))) <<  0 |
+		uint64_t(uint32_t(_mm_movemask_epi8(blank::mask(_mm_loadu_si128(vsrc + 1))))) << 16 |
+		uint64_t(uint32_t(_mm_movemask_epi8(blank::mask(_mm_loadu_si128(vsrc + 2))))) << 32 |
+		uint64_t(uint32_t(_mm_movemask_epi8(blank::mask(_mm_loadu_si128(vsrc + 3))))) << 48;
+}
+
+template < class blank >
+PRUNER_TARGET_SSSE3 inline uint64_t blanks64_ssse3(
+	uint8_t const* const src) {
+
+	__m128i const* const vsrc = reinterpret_cast< __m128i const* >(src);
+	return
+		uint64_t(uint32_t(_mm_movemask_epi8(blank::mask(_mm_loadu_si128(vsrc + 0))))) <<  0 |
+		uint64_t(uint32_t(_mm_movemask_epi8(blank::mask(_mm_loadu_si128(vsrc + 1))))) << 16 |
+		uint64_t(uint32_t(_mm_movemask_epi8(blank::mask(_mm_loadu_si128(vsrc + 2))))) << 32 |
+		uint64_t(uint32_t(_mm_movemask_epi8(blank::mask(_mm_loadu_si128(vsrc + 3))))) << 48;
+}
+
+template < class blank >
+PRUNER_TARGET_AVX2 inline uint64_t blanks64_avx2(
+	uint8_t const* const src) {
+
+	__m256i const* const vsrc = reinterpret_cast< __m256i const* >(src);
+	return
+		uint64_t(uint32_t(_mm256_movemask_epi8(blank::mask(_mm256_loadu_si256(vsrc + 0))))) <<  0 |
+		uint64_t(uint32_t(_mm256_movemask_epi8(blank::mask(_mm256_loadu_si256(vsrc + 1))))) << 32;
+}
+
+template < class blank >
+PRUNER_TARGET_AVX512VBMI2 inline uint64_t blanks64_avx512vbmi2(
+	uint8_t const* const src) {
+
+	return ~uint64_t(blank::keep(_mm512_loadu_si512(src)));
+}
+
+#endif
+// count of the non-blanks of src[0, len), by the given front
+template < uint64_t (& blanks64)(uint8_t const*), class blank >
+__attribute__ ((always_inline)) inline size_t count_blocks(
+	uint8_t const* const src,
+	size_t const len) {
+
+	size_t i = 0, count = 0;
+	for (; i + 128 <= len; i += 128)
+		count += 128 - __builtin_popcountll(blanks64(src + i)) - __builtin_popcountll(blanks64(src + i + 64));
+
+	for (; i + 64 <= len; i += 64)
+		count += 64 - __builtin_popcountll(blanks64(src + i));
+
+	for (; i < len; ++i)
+		count += blank::scalar(src[i]) ? 0 : 1;
+
+	return count;
+}
+
+// bitmap of the non-blanks of src[0, len), by the given front; bits past len come out clear
+template < uint64_t (& blanks64)(uint8_t const*), class blank >
+__attribute__ ((always_inline)) inline void bitmap_blocks(
+	uint8_t const* const src,
+	size_t const len,
+	uint64_t* const out) {
+
+	size_t i = 0;
+	for (; i + 128 <= len; i += 128) {
+		out[i / 64 + 0] = ~blanks64(src + i);
+		out[i / 64 + 1] = ~blanks64(src + i + 64);
+	}
+
+	for (; i + 64 <= len; i += 64)
+		out[i / 64] = ~blanks64(src + i);
+
+	if (i < len) {
+		uint64_t bits = 0;
+		for (size_t j = 0; i + j < len; ++j)
+			bits |= uint64_t(blank::scalar(src[i + j]) ? 0 : 1) << j;
+
+		out[i / 64] = bits;
+	}
+}
+
+#if __aarch64__
+// count of the non-blanks of src[0, len); rather than bitmaps, the blank masks get summed up bytewise -- 0xff being -1
+// -- on four sums, and summed across before they could wrap
+template < class blank >
+inline size_t count_kept_neon(
+	uint8_t const* const src,
+	size_t const len) {
+
+	size_t i = 0, blanks = 0;
+	while (i + 64 <= len) {
+		size_t const end = i + 255 * 64 < len ? i + 255 * 64 : len - 63;
+		uint8x16_t sum0 = vdupq_n_u8(0);
+		uint8x16_t sum1 = vdupq_n_u8(0);
+		uint8x16_t sum2 = vdupq_n_u8(0);
+		uint8x16_t sum3 = vdupq_n_u8(0);
+
+		for (; i < end; i += 64) {
+			sum0 = vsubq_u8(sum0, blank::mask(vld1q_u8(src + i + 0)));
+			sum1 = vsubq_u8(sum1, blank::mask(vld1q_u8(src + i + 16)));
+			sum2 = vsubq_u8(sum2, blank::mask(vld1q_u8(src + i + 32)));
+			sum3 = vsubq_u8(sum3, blank::mask(vld1q_u8(src + i + 48)));
+		}
+
+		blanks += vaddlvq_u8(sum0) + vaddlvq_u8(sum1) + vaddlvq_u8(sum2) + vaddlvq_u8(sum3);
+	}
+
+	for (; i < len; ++i)
+		blanks += blank::scalar(src[i]) ? 1 : 0;
+
+	return len - blanks;
+}
+
+#elif __x86_64__ || __i386__
+template < class blank >
+PRUNER_TARGET_SSE2 size_t count_kept_sse2(
+	uint8_t const* const src,
+	size_t const len) {
+
+	return count_blocks< blanks64_sse2< blank >, blank >(src, len);
+}
+
+template < class blank >
+PRUNER_TARGET_SSSE3 size_t count_kept_ssse3(
+	uint8_t const* const src,
+	size_t const len) {
+
+	return count_blocks< blanks64_ssse3< blank >, blank >(src, len);
+}
+
+template < class blank >
+PRUNER_TARGET_AVX2 size_t count_kept_avx2(
+	uint8_t const* const src,
+	size_t const len) {
+
+	return count_blocks< blanks64_avx2< blank >, blank >(src, len);
+}
+
+template < class blank >
+PRUNER_TARGET_AVX512VBMI2 size_t count_kept_avx512vbmi2(
+	uint8_t const* const src,
+	size_t const len) {
+
+	return count_blocks< blanks64_avx512vbmi2< blank >, blank >(src, len);
+}
+
+template < class blank >
+PRUNER_TARGET_SSE2 void blank_bitmap_sse2(
+	uint8_t const* const src,
+	size_t const len,
+	uint64_t* const out) {
+
+	bitmap_blocks< blanks64_sse2< blank >, blank >(src, len, out);
+}
+
+template < class blank >
+PRUNER_TARGET_SSSE3 void blank_bitmap_ssse3(
+	uint8_t const* const src,
+	size_t const len,
+	uint64_t* const out) {
+
+	bitmap_blocks< blanks64_ssse3< blank >, blank >(src, len, out);
+}
+
+template < class blank >
+PRUNER_TARGET_AVX2 void blank_bitmap_avx2(
+	uint8_t const* const src,
+	size_t const len,
+	uint64_t* const out) {
+
+	bitmap_blocks< blanks64_avx2< blank >, blank >(src, len, out);
+}
+
+template < class blank >
+PRUNER_TARGET_AVX512VBMI2 void blank_bitmap_avx512vbmi2(
+	uint8_t const* const src,
+	size_t const len,
+	uint64_t* const out) {
+
+	bitmap_blocks< blanks64_avx512vbmi2< blank >, blank >(src, len, out);
+}
+
+#endif
+// count the non-blanks in src[0, len) -- the count of chars prune() would output, sans the compaction -- by the front
+// of the given pruner, which the CPU must support
+template < class blank = blank_threshold<> >
+inline size_t count_kept(
+	uint8_t const* const src,
+	size_t const len,
+	prune_kernel const kernel) {
+
+	switch (kernel) {
+#if __aarch64__
+	case kernel_testee06:
+	case kernel_testee07:
+	case kernel_testee07_a72:
+	case kernel_testee08:
+	case kernel_testee14:
+		return count_kept_neon< blank >(src, len);
+
+#elif __x86_64__ || __i386__
+	case kernel_testee04:
+	case kernel_testee05:
+	case kernel_testee14:
+	case kernel_testee15:
+		return count_kept_ssse3< blank >(src, len);
+
+	case kernel_testee09:
+		return count_kept_avx2< blank >(src, len);
+
+	case kernel_testee10:
+		return count_kept_avx512vbmi2< blank >(src, len);
+
+	// the SSE2 front takes the compares alone; the lookups of blank_class go the scalar way
+	case kernel_testee16:
+		if (!blank_sse2< blank >::value)
+			return count_kept< blank >(src, len, kernel_testee00);
+
+		return count_kept_sse2< typename std::conditional< blank_sse2< blank >::value, blank, blank_threshold<> >::type >(
+			src, len);
+
+#endif
+	default: {
+		size_t count = 0;
+		for (size_t i = 0; i < len; ++i)
+			count += blank::scalar(src[i]) ? 0 : 1;
+
+		return count;
+	}
+	}
+}
+
+// count_kept() using the fastest pruner for the CPU at hand; sizes the output of prune() exactly
+template < class blank = blank_threshold<> >
+inline size_t count_kept(
+	uint8_t const* const src,
+	size_t const len) {
+
+	return count_kept< blank >(src, len, prune_default());
+}
+
+// Bitmap of the non-blanks in src[0, len), by the front of the given pruner, which the CPU must support: bit i % 64 of
+// out[i / 64] is set for a non-blank src[i]. out must have room for (len + 63) / 64 words; the bits past len in the
+// last word come out clear.
+template < class blank = blank_threshold<> >
+inline void blank_bitmap(
+	uint8_t const* const src,
+	size_t const len,
+	uint64_t* const out,
+	prune_kernel const kernel) {
+
+	switch (kernel) {
+#if __aarch64__
+	case kernel_testee06:
+	case kernel_testee07:
+	case kernel_testee07_a72:
+	case kernel_testee08:
+	case kernel_testee14:
+		bitmap_blocks< blanks64< blank >, blank >(src, len, out);
+		break;
+
+#elif __x86_64__ || __i386__
+	case kernel_testee04:
+	case kernel_testee05:
+	case kernel_testee14:
+	case kernel_testee15:
+		blank_bitmap_ssse3< blank >(src, len, out);
+		break;
+
+	case kernel_testee09:
+		blank_bitmap_avx2< blank >(src, len, out);
+		break;
+
+	case kernel_testee10:
+		blank_bitmap_avx512vbmi2< blank >(src, len, out);
+		break;
+
+	case kernel_testee16:
+		if (!blank_sse2< blank >::value)
+			blank_bitmap< blank >(src, len, out, kernel_testee00);
+		else
+			blank_bitmap_sse2< typename std::conditional< blank_sse2< blank >::value, blank, blank_threshold<> >::type >(
+				src, len, out);
+		break;
+
+#endif
+	default:
+		memset(out, 0, (len + 63) / 64 * sizeof(uint64_t));
+		for (size_t i = 0; i < len; ++i)
+			out[i / 64] |= uint64_t(blank::scalar(src[i]) ? 0 : 1) << i % 64;
+	}
+}
+
+// blank_bitmap() using the fastest pruner for the CPU at hand
+template < class blank = blank_threshold<> >
+inline void blank_bitmap(
+	uint8_t const* const src,
+	size_t const len,
+	uint64_t* const out) {
+
+	blank_bitmap< blank >(src, len, out, prune_default());
+}
+
+// run job(t) for each t in [0, threads), t = 0 on the calling thread and the rest on workers of their own; should a
+// worker fail to start, the calling thread takes its job and those of the workers after it; returns once all are done,
+// with every worker joined
+template < class job_t >
+inline void parallel_for(
+	std::vector< std::thread >& worker,
+	size_t const threads,
+	job_t const& job) {
+
+	size_t started = 1;
+
+	try {
+		for (; started < threads; ++started)
+			worker.emplace_back(job, started);
+	}
+	catch (std::exception const&) {
+	}
+
+	job(0);
+
+	for (size_t t = started; t < threads; ++t)
+		job(t);
+
+	for (size_t t = 0; t < worker.size(); ++t)
+		worker[t].join();
+
+	worker.clear();
+}
+
+// Prune all blanks from src[0, len) into dst on the given count of threads, zero standing for all hardware threads;
+// returns the count of non-blanks; dst must have room for len chars. Two passes over equal chunks of the input: the
+// first counts the non-blanks of each chunk, an exclusive prefix sum of those counts then gives the place of each
+// chunk in the output, and the second pass prunes each chunk straight into its place. Chunks are bounded by the next
+// chunk's place, so neighbouring threads never write to the same chars. Throws nothing: short of the memory or the
+// threads for all chunks, the calling thread prunes the chunks left over, or all of src.
+template < class blank = blank_threshold<> >
+inline size_t prune_parallel(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t threads,
+	prune_kernel const kernel) {
+
+	// below this, a thread is not worth its startup
+	size_t const min_chunk = size_t(1) << 16;
+
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if (threads > len / min_chunk)
+		threads = len / min_chunk;
+	if (threads < 2)
+		return prune< blank >(src, len, dst, kernel);
+
+	// cache-line-aligned chunks, the last one picking up the slack
+	size_t const chunk = (len / threads + 63) & ~size_t(63);
+	std::vector< size_t > offset;
+	std::vector< std::thread > worker;
+
+	try {
+		offset.assign(threads + 1, 0);
+		worker.reserve(threads - 1);
+	}
+	catch (std::bad_alloc const&) {
+		return prune< blank >(src, len, dst, kernel);
+	}
+
+	parallel_for(worker, threads, [=, &offset](size_t const t) {
+		size_t const begin = t * chunk < len ? t * chunk : len;
+		size_t const end = begin + chunk < len && t + 1 < threads ? begin + chunk : len;
+		offset[t + 1] = count_kept< blank >(src + begin, end - begin, kernel);
+	});
+
+	// exclusive prefix sum of the counts
+	for (size_t t = 1; t <= threads; ++t)
+		offset[t] += offset[t - 1];
+
+	parallel_for(worker, threads, [=, &offset](size_t const t) {
+		size_t const begin = t * chunk < len ? t * chunk : len;
+		size_t const end = begin + chunk < len && t + 1 < threads ? begin + chunk : len;
+		prune_bounded< blank >(src + begin, end - begin, dst + offset[t], offset[t + 1] - offset[t], kernel);
+	});
+
+	return offset[threads];
+}
+
+// prune_parallel() using the fastest pruner for the CPU at hand
+template < class blank = blank_threshold<> >
+inline size_t prune_parallel(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const threads = 0) {
+
+	return prune_parallel< blank >(src, len, dst, threads, prune_default());
+}
+
+#endif // ASCII_PRUNER_HPP_
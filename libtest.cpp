@@ -0,0 +1,161 @@
+// check of the C interface -- every entry point of the shared library against the header-only pruner it wraps, over
+// random input of all kinds of blanks, ASCII and UTF-8, at lengths from none to enough for several threads
+#include "ascii_pruner.h"
+#include "ascii_pruner.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+
+uint64_t random_state = 0x9e3779b97f4a7c15;
+
+uint64_t random_next() {
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+	return random_state;
+}
+
+// one of the entry points, checked at one length; reports a mismatch and counts it
+bool check(
+	bool const ok,
+	char const* const name,
+	size_t const len,
+	size_t& failed) {
+
+	if (!ok) {
+		fprintf(stderr, "error: %s at length %zu\n", name, len);
+		++failed;
+	}
+	return ok;
+}
+
+int main(int, char**) {
+	size_t const max_len = (size_t(1) << 20) + 13;
+	uint8_t* const src = static_cast< uint8_t* >(malloc(max_len));
+	uint8_t* const dst = static_cast< uint8_t* >(malloc(max_len));
+	uint8_t* const ref = static_cast< uint8_t* >(malloc(max_len));
+	uint32_t* const positions = static_cast< uint32_t* >(malloc(max_len * sizeof(uint32_t)));
+	uint32_t* const ref_positions = static_cast< uint32_t* >(malloc(max_len * sizeof(uint32_t)));
+	uint64_t* const bits = static_cast< uint64_t* >(malloc((max_len + 63) / 64 * sizeof(uint64_t)));
+	uint64_t* const ref_bits = static_cast< uint64_t* >(malloc((max_len + 63) / 64 * sizeof(uint64_t)));
+
+	// runs of blanks, quotes and backslashes for the quote-aware pruners, a no-break space for the UTF-8 one
+	for (size_t i = 0; i < max_len; ) {
+		uint64_t const r = random_next();
+
+		if (r % 16 == 0 && i + 2 <= max_len) {
+			src[i++] = 0xc2;
+			src[i++] = 0xa0;
+		}
+		else
+			src[i++] = r % 4 == 0 ? " \t\n\r\"\\"[(r >> 8) % 6] : 0x21 + (r >> 16) % 0x5e;
+	}
+
+	size_t const lens[] = { 0, 1, 15, 16, 17, 63, 64, 65, 1000, 4096 + 7, (size_t(1) << 18) + 1, max_len };
+	size_t failed = 0;
+
+	for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); ++l) {
+		size_t const len = lens[l];
+		size_t const ref_len = prune(src, len, ref);
+
+		check(ascii_prune(src, len, dst) == ref_len && memcmp(dst, ref, ref_len) == 0, "ascii_prune", len, failed);
+		check(ascii_prune_stream(src, len, dst) == ref_len && memcmp(dst, ref, ref_len) == 0,
+			"ascii_prune_stream", len, failed);
+
+		for (size_t threads = 0; threads < 4; ++threads)
+			check(ascii_prune_parallel(src, len, dst, threads) == ref_len && memcmp(dst, ref, ref_len) == 0,
+				"ascii_prune_parallel", len, failed);
+
+		memcpy(dst, src, len);
+		check(ascii_prune_in_place(dst, len) == ref_len && memcmp(dst, ref, ref_len) == 0,
+			"ascii_prune_in_place", len, failed);
+
+		check(ascii_count_kept(src, len) == ref_len, "ascii_count_kept", len, failed);
+
+		blank_bitmap(src, len, ref_bits);
+		ascii_blank_bitmap(src, len, bits);
+		check(memcmp(bits, ref_bits, (len + 63) / 64 * sizeof(uint64_t)) == 0, "ascii_blank_bitmap", len, failed);
+
+		// the state-carrying entry points, with and without the state
+		bool ref_run = false;
+		int run = 0;
+		size_t collapse_len = prune_collapse(src, len, ref, ref_run);
+		check(ascii_prune_collapse(src, len, dst, &run) == collapse_len && memcmp(dst, ref, collapse_len) == 0 &&
+			run == ref_run, "ascii_prune_collapse", len, failed);
+		check(ascii_prune_collapse(src, len, dst, NULL) == collapse_len && memcmp(dst, ref, collapse_len) == 0,
+			"ascii_prune_collapse", len, failed);
+
+		quote_state ref_quotes = { 0, 0 };
+		ascii_quote_state quotes = { 0, 0 };
+		size_t quoted_len = prune_quoted< true >(src, len, ref, ref_quotes);
+		check(ascii_prune_json(src, len, dst, &quotes) == quoted_len && memcmp(dst, ref, quoted_len) == 0 &&
+			quotes.in_string == ref_quotes.in_string && quotes.escaped == ref_quotes.escaped,
+			"ascii_prune_json", len, failed);
+		check(ascii_prune_json(src, len, dst, NULL) == quoted_len && memcmp(dst, ref, quoted_len) == 0,
+			"ascii_prune_json", len, failed);
+
+		ref_quotes.in_string = ref_quotes.escaped = 0;
+		quotes.in_string = quotes.escaped = 0;
+		quoted_len = prune_quoted< false >(src, len, ref, ref_quotes);
+		check(ascii_prune_csv(src, len, dst, &quotes) == quoted_len && memcmp(dst, ref, quoted_len) == 0 &&
+			quotes.in_string == ref_quotes.in_string && quotes.escaped == ref_quotes.escaped,
+			"ascii_prune_csv", len, failed);
+
+		size_t const positions_len = prune_positions(src, len, ref, ref_positions);
+		check(ascii_prune_positions(src, len, dst, positions) == positions_len &&
+			memcmp(dst, ref, positions_len) == 0 &&
+			memcmp(positions, ref_positions, positions_len * sizeof(uint32_t)) == 0,
+			"ascii_prune_positions", len, failed);
+
+		bool ref_valid;
+		int valid = -1;
+		size_t const utf8_len = prune_utf8(src, len, ref, ref_valid);
+		check(ascii_prune_utf8(src, len, dst, &valid) == utf8_len && memcmp(dst, ref, utf8_len) == 0 &&
+			valid == ref_valid, "ascii_prune_utf8", len, failed);
+		check(ascii_prune_utf8(src, len, dst, NULL) == utf8_len && memcmp(dst, ref, utf8_len) == 0,
+			"ascii_prune_utf8", len, failed);
+	}
+
+	// batches of strings over a small arena, so the outputs spill over its chunks, then once more after a reset
+	ascii_arena* const arena = ascii_arena_new(256);
+	size_t const n = 64;
+	ascii_view in[n], results[n];
+
+	check(arena != NULL, "ascii_arena_new", 0, failed);
+
+	for (size_t pass = 0; pass < 2 && arena != NULL; ++pass) {
+		size_t sum = 0;
+
+		for (size_t s = 0; s < n; ++s) {
+			uint64_t const r = random_next();
+			in[s].len = r % 8 ? (r >> 8) % 300 : 0;
+			in[s].data = src + (r >> 32) % (max_len - in[s].len);
+			sum += prune(in[s].data, in[s].len, ref);
+		}
+
+		check(ascii_prune_batch(in, n, arena, results) == sum, "ascii_prune_batch", n, failed);
+
+		for (size_t s = 0; s < n; ++s) {
+			size_t const ref_len = prune(in[s].data, in[s].len, ref);
+			check(results[s].len == ref_len && memcmp(results[s].data, ref, ref_len) == 0,
+				"ascii_prune_batch", in[s].len, failed);
+		}
+
+		ascii_arena_reset(arena);
+	}
+
+	ascii_arena_free(arena);
+	ascii_arena_free(NULL);
+
+	check(strcmp(ascii_pruner_kernel(), prune_kernel_name(prune_default())) == 0, "ascii_pruner_kernel", 0, failed);
+
+	fprintf(stdout, "%s: %s\n", ascii_pruner_kernel(), failed ? "FAILED" : "ok");
+
+	free(ref_bits);
+	free(bits);
+	free(ref_positions);
+	free(positions);
+	free(ref);
+	free(dst);
+	free(src);
+	return failed ? 1 : 0;
+}
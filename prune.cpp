@@ -1,19 +1,18 @@
 // pruning of blanks from an ascii stream -- timing of candidate routines
-#if defined(__ARM_FEATURE_SVE)
-	#include <arm_sve.h>
-#endif
-#if __aarch64__
-	#include <arm_neon.h>
-#elif __SSSE3__
-	#include <tmmintrin.h>
-#elif __SSE2__
-	#include <emmintrin.h>
-#endif
-#if __POPCNT__
-	#include <popcntintrin.h>
-#endif
+#include "ascii_pruner.hpp"
 #include <stdio.h>
-#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <unistd.h>
+#if __linux__
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+#endif
+#include <algorithm>
+#include <vector>
 
 uint8_t input[64] __attribute__ ((aligned(64))) =
 	"012345 6789  abc"
@@ -112,748 +111,2066 @@ void print_uint8x16(
 }
 
 #endif
-// fully-scalar version; good performance on both amd64 and arm64 above-entry-level parts;
-// particularly on cortex-a72 this does an IPC of 2.94 which is excellent! ryzen also
-// does an IPC above 4, which is remarkable
-inline size_t testee00() {
-	size_t i = 0, pos = 0;
-	while (i < 16) {
-		const char c = input[i++];
-		output[pos] = c;
-		pos += (c > 32 ? 1 : 0);
+// scaling of prune_parallel from a single thread up to all hardware threads, over a buffer of the given MiB of input
+int scaling(size_t const mib) {
+	size_t const len = mib << 20;
+	uint8_t* const src = static_cast< uint8_t* >(malloc(len));
+	uint8_t* const dst = static_cast< uint8_t* >(malloc(len));
+
+	if (src == NULL || dst == NULL) {
+		fprintf(stderr, "error: cannot allocate %zu MiB\n", mib * 2);
+		return 1;
 	}
+
+	for (size_t i = 0; i < len; ++i)
+		src[i] = input[i % 32];
+
+	memset(dst, 0, len);
+
+	size_t const max_threads = std::thread::hardware_concurrency();
+	fprintf(stdout, "threads, GB/s\n");
+
+	for (size_t threads = 1; threads <= max_threads; ++threads) {
+		double best = 0;
+
+		for (size_t trial = 0; trial < 5; ++trial) {
+			timespec t0, t1;
+			clock_gettime(CLOCK_MONOTONIC, &t0);
+			prune_parallel(src, len, dst, threads);
+			clock_gettime(CLOCK_MONOTONIC, &t1);
+
+			double const sec = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+			if (best == 0 || sec < best)
+				best = sec;
+		}
+		fprintf(stdout, "%zu, %.3f\n", threads, len / best * 1e-9);
+	}
+
+	free(dst);
+	free(src);
+	return 0;
+}
+
+// scalar reference for the checks below
+template < class blank = blank_threshold<> >
+size_t reference(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst) {
+
+	size_t pos = 0;
+	for (size_t i = 0; i < len; ++i)
+		if (!blank::scalar(src[i]))
+			dst[pos++] = src[i];
 	return pos;
 }
 
-#if __aarch64__
-// naive pruner, 16-batch; filter single blank from N input chars, followed by K optional trailing blanks, N + K = batch size
-// example: "1234 678  " -> "1234678" (N + K = 10)
-inline size_t testee01() {
-	uint8x16_t const vinput = vld1q_u8(input);
-	uint8x16_t prfsum = vcleq_u8(vinput, vdupq_n_u8(' '));
-
-	// pick one:
-	// before computing the prefix sum: count_of_blanks := vaddvq_u8(prfsum)
-	// after computing the prefix sum: count_of_blanks := prfsum[last_lane]
-	prfsum = vaddq_u8(prfsum, vextq_u8(vdupq_n_u8(0), prfsum, 16 - 1));
-	prfsum = vaddq_u8(prfsum, vextq_u8(vdupq_n_u8(0), prfsum, 16 - 2));
-	prfsum = vaddq_u8(prfsum, vextq_u8(vdupq_n_u8(0), prfsum, 16 - 4));
-	prfsum = vaddq_u8(prfsum, vextq_u8(vdupq_n_u8(0), prfsum, 16 - 8));
-
-	int8_t const bnum = vgetq_lane_u8(prfsum, 15);
-
-	uint8x16_t const index = vsubq_u8((uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 }, prfsum);
-	uint8x16_t const res = vqtbl1q_u8(vinput, index);
-
-	vst1q_u8(output, res);
-	return sizeof(uint8x16_t) + bnum;
-}
-
-// naive pruner, 32-batch; filter single blank from N input chars, followed by K optional trailing blanks, N + K = half batch size
-// example: "1234 678  " -> "1234678" (N + K = 10)
-inline size_t testee02() {
-	uint8x16_t const vinput0 = vld1q_u8(input);
-	uint8x16_t const vinput1 = vld1q_u8(input + sizeof(uint8x16_t));
-	uint8x16_t prfsum0 = vcleq_u8(vinput0, vdupq_n_u8(' '));
-	uint8x16_t prfsum1 = vcleq_u8(vinput1, vdupq_n_u8(' '));
-
-	// pick one:
-	// before computing the prefix sum: count_of_blanks := vaddvq_u8(prfsum)
-	// after computing the prefix sum: count_of_blanks := prfsum[last_lane]
-	prfsum0 = vaddq_u8(prfsum0, vextq_u8(vdupq_n_u8(0), prfsum0, 16 - 1));
-	prfsum1 = vaddq_u8(prfsum1, vextq_u8(vdupq_n_u8(0), prfsum1, 16 - 1));
-	prfsum0 = vaddq_u8(prfsum0, vextq_u8(vdupq_n_u8(0), prfsum0, 16 - 2));
-	prfsum1 = vaddq_u8(prfsum1, vextq_u8(vdupq_n_u8(0), prfsum1, 16 - 2));
-	prfsum0 = vaddq_u8(prfsum0, vextq_u8(vdupq_n_u8(0), prfsum0, 16 - 4));
-	prfsum1 = vaddq_u8(prfsum1, vextq_u8(vdupq_n_u8(0), prfsum1, 16 - 4));
-	prfsum0 = vaddq_u8(prfsum0, vextq_u8(vdupq_n_u8(0), prfsum0, 16 - 8));
-	prfsum1 = vaddq_u8(prfsum1, vextq_u8(vdupq_n_u8(0), prfsum1, 16 - 8));
-
-	int8_t const bnum0 = vgetq_lane_u8(prfsum0, 15);
-	int8_t const bnum1 = vgetq_lane_u8(prfsum1, 15);
-
-	uint8x16_t const index0 = vsubq_u8((uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 }, prfsum0);
-	uint8x16_t const index1 = vsubq_u8((uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 }, prfsum1);
-	uint8x16_t const res0 = vqtbl1q_u8(vinput0, index0);
-	uint8x16_t const res1 = vqtbl1q_u8(vinput1, index1);
-
-	vst1q_u8(output, res0);
-	vst1q_u8(output + sizeof(uint8x16_t) + bnum0, res1);
-	return sizeof(uint8x16_t) * 2 + bnum0 + bnum1;
-}
-
-#elif __SSSE3__
-// naive pruner, 16-batch; filter single blank from N input chars, followed by K optional trailing blanks, N + K = batch size
-// example: "1234 678  " -> "1234678" (N + K = 10)
-inline size_t testee01() {
-	__m128i const vinput = _mm_load_si128(reinterpret_cast< const __m128i* >(input));
-	__m128i prfsum = _mm_cmplt_epi8(vinput, _mm_set1_epi8(' ' + 1));
-
-	// pick one:
-	// before computing the prefix sum: count_of_blanks := _mm_popcnt_u32(_mm_movemask_epi8(prfsum))
-	// after computing the prefix sum: count_of_blanks := prfsum[last_lane]
-	prfsum = _mm_add_epi8(prfsum, _mm_slli_si128(prfsum, 1));
-	prfsum = _mm_add_epi8(prfsum, _mm_slli_si128(prfsum, 2));
-	prfsum = _mm_add_epi8(prfsum, _mm_slli_si128(prfsum, 4));
-	prfsum = _mm_add_epi8(prfsum, _mm_slli_si128(prfsum, 8));
-
-	int8_t const bnum = uint16_t(_mm_extract_epi16(prfsum, 7)) >> 8;
-
-	__m128i const index = _mm_sub_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), prfsum);
-	__m128i const res = _mm_shuffle_epi8(vinput, index);
-
-	_mm_storeu_si128(reinterpret_cast< __m128i* >(output), res);
-	return sizeof(__m128i) + bnum;
-}
-
-// naive pruner, 32-batch; filter single blank from N input chars, followed by K optional trailing blanks, N + K = half batch size
-// example: "1234 678  " -> "1234678" (N + K = 10)
-inline size_t testee02() {
-	__m128i const vinput0 = _mm_load_si128(reinterpret_cast< const __m128i* >(input));
-	__m128i const vinput1 = _mm_load_si128(reinterpret_cast< const __m128i* >(input) + 1);
-	__m128i prfsum0 = _mm_cmplt_epi8(vinput0, _mm_set1_epi8(' ' + 1));
-	__m128i prfsum1 = _mm_cmplt_epi8(vinput1, _mm_set1_epi8(' ' + 1));
-
-	// pick one:
-	// before computing the prefix sum: count_of_blanks := _mm_popcnt_u32(_mm_movemask_epi8(prfsum))
-	// after computing the prefix sum: count_of_blanks := prfsum[last_lane]
-	prfsum0 = _mm_add_epi8(prfsum0, _mm_slli_si128(prfsum0, 1));
-	prfsum1 = _mm_add_epi8(prfsum1, _mm_slli_si128(prfsum1, 1));
-	prfsum0 = _mm_add_epi8(prfsum0, _mm_slli_si128(prfsum0, 2));
-	prfsum1 = _mm_add_epi8(prfsum1, _mm_slli_si128(prfsum1, 2));
-	prfsum0 = _mm_add_epi8(prfsum0, _mm_slli_si128(prfsum0, 4));
-	prfsum1 = _mm_add_epi8(prfsum1, _mm_slli_si128(prfsum1, 4));
-	prfsum0 = _mm_add_epi8(prfsum0, _mm_slli_si128(prfsum0, 8));
-	prfsum1 = _mm_add_epi8(prfsum1, _mm_slli_si128(prfsum1, 8));
-
-	int8_t const bnum0 = uint16_t(_mm_extract_epi16(prfsum0, 7)) >> 8;
-	int8_t const bnum1 = uint16_t(_mm_extract_epi16(prfsum1, 7)) >> 8;
-
-	__m128i const index0 = _mm_sub_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), prfsum0);
-	__m128i const index1 = _mm_sub_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), prfsum1);
-	__m128i const res0 = _mm_shuffle_epi8(vinput0, index0);
-	__m128i const res1 = _mm_shuffle_epi8(vinput1, index1);
-
-	_mm_storeu_si128(reinterpret_cast< __m128i* >(output), res0);
-	_mm_storeu_si128(reinterpret_cast< __m128i* >(output + sizeof(__m128i) + bnum0), res1);
-	return sizeof(__m128i) * 2 + bnum0 + bnum1;
-}
-
-#if __POPCNT__
-// pruner semi, 16-batch; replace blanks with the next non-blank, cutting off trailing blanks from the batch
-// example: "1234 678  " -> "12346678"
-inline size_t testee03() {
-	__m128i const vin = _mm_load_si128(reinterpret_cast< const __m128i* >(input));
-
-	// discover non-blanks
-	__m128i const pos = _mm_cmpgt_epi8(vin, _mm_set1_epi8(' '));
-
-	// mark blanks as ones
-	__m128i const spc = _mm_andnot_si128(pos, _mm_set1_epi8(1));
-
-	// prefix-sum the blanks, right to left
-	__m128i prfsum = spc;
-	prfsum = _mm_add_epi8(prfsum, _mm_srli_si128(prfsum, 1));
-	prfsum = _mm_add_epi8(prfsum, _mm_srli_si128(prfsum, 2));
-	prfsum = _mm_add_epi8(prfsum, _mm_srli_si128(prfsum, 4));
-	prfsum = _mm_add_epi8(prfsum, _mm_srli_si128(prfsum, 8));
-
-	// isolate sequences of blanks and count their individual lengths, right to left, using a prefix max and the above prefix sum
-	__m128i prfmax = _mm_and_si128(pos, prfsum);
-	prfmax = _mm_max_epu8(prfmax, _mm_srli_si128(prfmax, 1));
-	prfmax = _mm_max_epu8(prfmax, _mm_srli_si128(prfmax, 2));
-	prfmax = _mm_max_epu8(prfmax, _mm_srli_si128(prfmax, 4));
-	prfmax = _mm_max_epu8(prfmax, _mm_srli_si128(prfmax, 8));
-	prfmax = _mm_sub_epi8(prfsum, prfmax);
-
-	// add blank counts to a sequential index to get non-blanks index
-	__m128i const index = _mm_add_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), prfmax);
+// scalar reference of prune_collapse()
+template < class blank = blank_threshold<> >
+size_t reference_collapse(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	bool& run) {
+
+	size_t pos = 0;
+	for (size_t i = 0; i < len; ++i) {
+		bool const b = blank::scalar(src[i]);
+		if (!b || !run)
+			dst[pos++] = b ? ' ' : src[i];
+		run = b;
+	}
+	return pos;
+}
 
-	// cap trailing out-of-bounds in the index
-	__m128i const indey = _mm_or_si128(index, _mm_cmpgt_epi8(index, _mm_set1_epi8(15)));
-
-	// use the index to fetch all non-blanks from the dictionary
-	__m128i const res = _mm_shuffle_epi8(vin, indey);
-
-	_mm_storeu_si128(reinterpret_cast< __m128i* >(output), res);
-	return sizeof(__m128i) - _mm_popcnt_u32(_mm_movemask_epi8(indey));
+// scalar reference of prune_quoted(); a backslash escapes the next char in or out of strings, as with the pruners
+template < bool escapes >
+size_t reference_quoted(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	bool& in_string,
+	bool& escaped) {
+
+	size_t pos = 0;
+	for (size_t i = 0; i < len; ++i) {
+		uint8_t const c = src[i];
+		if (in_string || c > ' ')
+			dst[pos++] = c;
+
+		if (escaped)
+			escaped = false;
+		else if (escapes && c == '\\')
+			escaped = true;
+		else if (c == '"')
+			in_string = !in_string;
+	}
+	return pos;
 }
 
-#endif
-#endif
-// From here on start the proper pruners. They all implement the following idea:
-//
-//  1. Get the unperturbed index of all elements of a vector, e.g. { 0, 1, 2, 3, 4, 5, 6, 7 } for an 8-element vector
-//  2. For all blank lanes in the input ascii vector, raise the corresponding lanes in the index vector to MAX_INT, e.g. { 0, 1, 0xff, 3, 0xff, 0xff, 6, 7 }
-//  3. Sort the resulting index vector in ascending order, e.g. { 0, 1, 3, 6, 7, 0xff, 0xff, 0xff }
-//
-// This is the desired index by which to sample the original input vector. That's all.
+// scalar reference of prune_utf8(): decodes the chars per the table of well-formed UTF-8, and drops the code points
+// that are Unicode blanks; each char of an ill-formed sequence goes to the output on its own
+size_t reference_utf8(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	bool& valid) {
+
+	size_t pos = 0;
+	valid = true;
+
+	for (size_t i = 0; i < len; ) {
+		uint8_t const c = src[i];
+		size_t n = 0;
+		uint8_t lo = 0x80, hi = 0xbf; // bounds of the second char
+
+		if (c < 0x80)
+			n = 1;
+		else if (c >= 0xc2 && c <= 0xdf)
+			n = 2;
+		else if (c >= 0xe0 && c <= 0xef) {
+			n = 3;
+			lo = c == 0xe0 ? 0xa0 : 0x80;
+			hi = c == 0xed ? 0x9f : 0xbf;
+		}
+		else if (c >= 0xf0 && c <= 0xf4) {
+			n = 4;
+			lo = c == 0xf0 ? 0x90 : 0x80;
+			hi = c == 0xf4 ? 0x8f : 0xbf;
+		}
+
+		bool ok = n != 0 && i + n <= len;
+		for (size_t j = 1; ok && j < n; ++j)
+			ok = src[i + j] >= (j == 1 ? lo : 0x80) && src[i + j] <= (j == 1 ? hi : 0xbf);
+
+		if (!ok) {
+			valid = false;
+			dst[pos++] = c;
+			++i;
+			continue;
+		}
+
+		uint32_t cp = n == 1 ? c : c & 0x7f >> n;
+		for (size_t j = 1; j < n; ++j)
+			cp = cp << 6 | (src[i + j] & 0x3f);
+
+		bool const blank = cp <= ' ' || cp == 0x85 || cp == 0xa0 || cp == 0x1680 || (cp >= 0x2000 && cp <= 0x200a) ||
+			cp == 0x2028 || cp == 0x2029 || cp == 0x202f || cp == 0x205f || cp == 0x3000;
+
+		if (!blank) {
+			memcpy(dst + pos, src + i, n);
+			pos += n;
+		}
+		i += n;
+	}
+	return pos;
+}
 
-#if __aarch64__
-// pruner proper, 16-batch; q-form (128-bit regs) half-utilized
-inline size_t testee04() {
-	uint8x16_t const vin = vld1q_u8(input);
-	uint8x16_t const bmask = vcleq_u8(vin, vdupq_n_u8(' '));
-
-	// OR the mask of all blanks with the original index of the vector
-	uint8x16_t const risen = vorrq_u8(bmask, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
-
-	// now just sort that 'risen' to get the desired index of all non-blanks in the front, and all blanks in the back
-
-	// 16-element sorting network: http://pages.ripco.net/~jgamble/nw.html -- 'Best version'
-	// stage 0
-	uint8x16_t const st0a = vqtbl1q_u8(risen, (uint8x16_t) { 0, 2, 4, 6, 8, 10, 12, 14, });
-	uint8x16_t const st0b = vqtbl1q_u8(risen, (uint8x16_t) { 1, 3, 5, 7, 9, 11, 13, 15, });
-	uint8x16_t const st0min = vminq_u8(st0a, st0b); //  0,  2,  4,  6,  8, 10, 12, 14
-	uint8x16_t const st0max = vmaxq_u8(st0a, st0b); //  1,  3,  5,  7,  9, 11, 13, 15
-
-	// stage 1
-	uint8x16x2_t const st0 = { { st0min, st0max } };
-	uint8x16_t const st1a = vqtbl2q_u8(st0, (uint8x16_t) { 0, 2, 4, 6, 16, 18, 20, 22, });
-	uint8x16_t const st1b = vqtbl2q_u8(st0, (uint8x16_t) { 1, 3, 5, 7, 17, 19, 21, 23, });
-	uint8x16_t const st1min = vminq_u8(st1a, st1b); //  0,  4,  8, 12,  1,  5,  9, 13
-	uint8x16_t const st1max = vmaxq_u8(st1a, st1b); //  2,  6, 10, 14,  3,  7, 11, 15
-
-	// stage 2
-	uint8x16x2_t const st1 = { { st1min, st1max } };
-	uint8x16_t const st2a = vqtbl2q_u8(st1, (uint8x16_t) { 0, 2, 4, 6, 16, 18, 20, 22, });
-	uint8x16_t const st2b = vqtbl2q_u8(st1, (uint8x16_t) { 1, 3, 5, 7, 17, 19, 21, 23, });
-	uint8x16_t const st2min = vminq_u8(st2a, st2b); //  0,  8,  1,  9,  2, 10,  3, 11
-	uint8x16_t const st2max = vmaxq_u8(st2a, st2b); //  4, 12,  5, 13,  6, 14,  7, 15
-
-	// stage 3
-	uint8x16x2_t const st2 = { { st2min, st2max } };
-	uint8x16_t const st3a = vqtbl2q_u8(st2, (uint8x16_t) { 0, 2, 4, 6, 16, 18, 20, 22, });
-	uint8x16_t const st3b = vqtbl2q_u8(st2, (uint8x16_t) { 1, 3, 5, 7, 17, 19, 21, 23, });
-	uint8x16_t const st3min = vminq_u8(st3a, st3b); // 0, 1,  2,  3,  4,  5,  6,  7
-	uint8x16_t const st3max = vmaxq_u8(st3a, st3b); // 8, 9, 10, 11, 12, 13, 14, 15
-
-	// from here on some indices are already done -- freeze them, by keeping them in deterministic positions
-
-	// stage 4; indices done so far: 0, 15
-	uint8x16x2_t const st3 = { { st3min, st3max } };
-	uint8x16_t const st4a = vqtbl2q_u8(st3, (uint8x16_t) {  0,  5,  6,  3, 21,  7, 1,  4, });
-	uint8x16_t const st4b = vqtbl2q_u8(st3, (uint8x16_t) { 23, 18, 17, 20, 22, 19, 2, 16, });
-	uint8x16_t const st4min = vminq_u8(st4a, st4b); // [ 0],  5,  6,  3, 13,  7,  1,  4
-	uint8x16_t const st4max = vmaxq_u8(st4a, st4b); // [15], 10,  9, 12, 14, 11,  2,  8
-
-	// stage 5; done so far: 0, 15; temp frozen: 3, 12
-	uint8x16x2_t const st4 = { { st4min, st4max } };
-	uint8x16_t const st5a = vqtbl2q_u8(st4, (uint8x16_t) {  0,  3, 6, 5, 22, 21, 1, 18, });
-	uint8x16_t const st5b = vqtbl2q_u8(st4, (uint8x16_t) { 16, 19, 7, 4, 23, 20, 2, 17, });
-	uint8x16_t const st5min = vminq_u8(st5a, st5b); // [ 0], [ 3], 1,  7, 2, 11, 5,  9
-	uint8x16_t const st5max = vmaxq_u8(st5a, st5b); // [15], [12], 4, 13, 8, 14, 6, 10
-
-	// stage 6; done so far: 0, 1, 14, 15; temp frozen: 5, 6, 9, 10
-	uint8x16x2_t const st5 = { { st5min, st5max } };
-	uint8x16_t const st6a = vqtbl2q_u8(st5, (uint8x16_t) {  0,  2,  4,  5,  1,  3,  6,  7, });
-	uint8x16_t const st6b = vqtbl2q_u8(st5, (uint8x16_t) { 16, 21, 18, 19, 20, 17, 22, 23, });
-	uint8x16_t const st6min = vminq_u8(st6a, st6b); // [ 0], [ 1], 2, 11, 3,  7, [5], [ 9]
-	uint8x16_t const st6max = vmaxq_u8(st6a, st6b); // [15], [14], 4, 13, 8, 12, [6], [10]
-
-	// stage 7; done so far: 0, 1, 2, 13, 14, 15; temp frozen: 4, 11
-	uint8x16x2_t const st6 = { { st6min, st6max } };
-	uint8x16_t const st7a = vqtbl2q_u8(st6, (uint8x16_t) {  0,  1,  2,  3, 22, 23, 4, 5, });
-	uint8x16_t const st7b = vqtbl2q_u8(st6, (uint8x16_t) { 16, 17, 18, 19, 20, 21, 6, 7, });
-	uint8x16_t const st7min = vminq_u8(st7a, st7b); // [ 0], [ 1], [2], [11], 6, 10, 3, 7
-	uint8x16_t const st7max = vmaxq_u8(st7a, st7b); // [15], [14], [4], [13], 8, 12, 5, 9
-
-	// stage 8; done so far: 0, 1, 2, 13, 14, 15
-	uint8x16x2_t const st7 = { { st7min, st7max } };
-	uint8x16_t const st8a = vqtbl2q_u8(st7, (uint8x16_t) {  0,  1,  2,  6, 22,  7, 23,  3, });
-	uint8x16_t const st8b = vqtbl2q_u8(st7, (uint8x16_t) { 16, 17, 19, 18,  4, 20,  5, 21, });
-	uint8x16_t const st8min = vminq_u8(st8a, st8b); // [ 0], [ 1], [ 2], 3, 5, 7,  9, 11
-	uint8x16_t const st8max = vmaxq_u8(st8a, st8b); // [15], [14], [13], 4, 6, 8, 10, 12
-
-	// stage 9; done so far: 0, 1, 2, 3, 4, 5, 10, 11, 12, 13, 14, 15
-	uint8x16x2_t const st8 = { { st8min, st8max } };
-	uint8x16_t const st9a = vqtbl2q_u8(st8, (uint8x16_t) {  0,  1,  2,  3, 19,  4, 20, 21, });
-	uint8x16_t const st9b = vqtbl2q_u8(st8, (uint8x16_t) { 16, 17, 18, 23,  7, 22,  5,  6, });
-	uint8x16_t const st9min = vminq_u8(st9a, st9b); // [ 0], [ 1], [ 2], [ 3], [ 4], [ 5], 6, 8
-	uint8x16_t const st9max = vmaxq_u8(st9a, st9b); // [15], [14], [13], [12], [11], [10], 7, 9
-
-	uint8x16x2_t const st9 = { { st9min, st9max } };
-	uint8x16_t const index = vqtbl2q_u8(st9, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 22, 7, 23, 21, 20, 19, 18, 17, 16 });
-
-	uint8x16_t const res = vqtbl1q_u8(vin, index);
-	vst1q_u8(output, res);
-	return sizeof(uint8x16_t) + int8_t(vaddvq_u8(bmask));
-}
-
-// pruner proper, 16-batch; d-form (64-bit regs) version of testee04
-inline size_t testee05() {
-	uint8x16_t const vin = vld1q_u8(input);
-	uint8x16_t const bmask = vcleq_u8(vin, vdupq_n_u8(' '));
-
-	// OR the mask of all blanks with the original index of the vector
-	uint8x16_t const risen = vorrq_u8(bmask, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
-
-	// now just sort that 'risen' to get the desired index of all non-blanks in the front, and all blanks in the back
-
-	// 16-element sorting network: http://pages.ripco.net/~jgamble/nw.html -- 'Best version'
-	// stage 0
-	uint8x8_t const st0a = vqtbl1_u8(risen, (uint8x8_t) { 0, 2, 4, 6, 8, 10, 12, 14 });
-	uint8x8_t const st0b = vqtbl1_u8(risen, (uint8x8_t) { 1, 3, 5, 7, 9, 11, 13, 15 });
-	uint8x8_t const st0min = vmin_u8(st0a, st0b); //  0,  2,  4,  6,  8, 10, 12, 14
-	uint8x8_t const st0max = vmax_u8(st0a, st0b); //  1,  3,  5,  7,  9, 11, 13, 15
-
-	// stage 1
-	uint8x8x2_t const st0 = { { st0min, st0max } };
-	uint8x8_t const st1a = vtbl2_u8(st0, (uint8x8_t) { 0, 2, 4, 6, 8, 10, 12, 14 });
-	uint8x8_t const st1b = vtbl2_u8(st0, (uint8x8_t) { 1, 3, 5, 7, 9, 11, 13, 15 });
-	uint8x8_t const st1min = vmin_u8(st1a, st1b); //  0,  4,  8, 12,  1,  5,  9, 13
-	uint8x8_t const st1max = vmax_u8(st1a, st1b); //  2,  6, 10, 14,  3,  7, 11, 15
-
-	// stage 2
-	uint8x8x2_t const st1 = { { st1min, st1max } };
-	uint8x8_t const st2a = vtbl2_u8(st1, (uint8x8_t) { 0, 2, 4, 6, 8, 10, 12, 14 });
-	uint8x8_t const st2b = vtbl2_u8(st1, (uint8x8_t) { 1, 3, 5, 7, 9, 11, 13, 15 });
-	uint8x8_t const st2min = vmin_u8(st2a, st2b); //  0,  8,  1,  9,  2, 10,  3, 11
-	uint8x8_t const st2max = vmax_u8(st2a, st2b); //  4, 12,  5, 13,  6, 14,  7, 15
-
-	// stage 3
-	uint8x8x2_t const st2 = { { st2min, st2max } };
-	uint8x8_t const st3a = vtbl2_u8(st2, (uint8x8_t) { 0, 2, 4, 6, 8, 10, 12, 14 });
-	uint8x8_t const st3b = vtbl2_u8(st2, (uint8x8_t) { 1, 3, 5, 7, 9, 11, 13, 15 });
-	uint8x8_t const st3min = vmin_u8(st3a, st3b); // 0, 1,  2,  3,  4,  5,  6,  7
-	uint8x8_t const st3max = vmax_u8(st3a, st3b); // 8, 9, 10, 11, 12, 13, 14, 15
-
-	// from here on some indices are already done -- freeze them, by keeping them in deterministic positions
-
-	// stage 4; indices done so far: 0, 15
-	uint8x8x2_t const st3 = { { st3min, st3max } };
-	uint8x8_t const st4a = vtbl2_u8(st3, (uint8x8_t) {  0,  5,  6,  3, 13,  7,  1,  4 });
-	uint8x8_t const st4b = vtbl2_u8(st3, (uint8x8_t) { 15, 10,  9, 12, 14, 11,  2,  8 });
-	uint8x8_t const st4min = vmin_u8(st4a, st4b); // [ 0],  5,  6,  3, 13,  7,  1,  4
-	uint8x8_t const st4max = vmax_u8(st4a, st4b); // [15], 10,  9, 12, 14, 11,  2,  8
-
-	// stage 5; done so far: 0, 15; temp frozen: 3, 12
-	uint8x8x2_t const st4 = { { st4min, st4max } };
-	uint8x8_t const st5a = vtbl2_u8(st4, (uint8x8_t) {  0,    3, 6,  5, 14, 13, 1, 10 });
-	uint8x8_t const st5b = vtbl2_u8(st4, (uint8x8_t) {  8,   11, 7,  4, 15, 12, 2,  9 });
-	uint8x8_t const st5min = vmin_u8(st5a, st5b); // [ 0], [ 3], 1,  7,  2, 11, 5,  9
-	uint8x8_t const st5max = vmax_u8(st5a, st5b); // [15], [12], 4, 13,  8, 14, 6, 10
-
-	// stage 6; done so far: 0, 1, 14, 15; temp frozen: 5, 6, 9, 10
-	uint8x8x2_t const st5 = { { st5min, st5max } };
-	uint8x8_t const st6a = vtbl2_u8(st5, (uint8x8_t) {  0,   2,  4,  5,  1,  3,  6,    7 });
-	uint8x8_t const st6b = vtbl2_u8(st5, (uint8x8_t) {  8,  13, 10, 11, 12,  9, 14,   15 });
-	uint8x8_t const st6min = vmin_u8(st6a, st6b); // [ 0], [ 1], 2, 11,  3,  7, [5], [ 9]
-	uint8x8_t const st6max = vmax_u8(st6a, st6b); // [15], [14], 4, 13,  8, 12, [6], [10]
-
-	// stage 7; done so far: 0, 1, 2, 13, 14, 15; temp frozen: 4, 11
-	uint8x8x2_t const st6 = { { st6min, st6max } };
-	uint8x8_t const st7a = vtbl2_u8(st6, (uint8x8_t) {  0,   1,    2,    3, 14, 15, 4, 5 });
-	uint8x8_t const st7b = vtbl2_u8(st6, (uint8x8_t) {  8,   9,   10,   11, 12, 13, 6, 7 });
-	uint8x8_t const st7min = vmin_u8(st7a, st7b); // [ 0], [ 1], [2], [11],  6, 10, 3, 7
-	uint8x8_t const st7max = vmax_u8(st7a, st7b); // [15], [14], [4], [13],  8, 12, 5, 9
-
-	// stage 8; done so far: 0, 1, 2, 13, 14, 15
-	uint8x8x2_t const st7 = { { st7min, st7max } };
-	uint8x8_t const st8a = vtbl2_u8(st7, (uint8x8_t) {  0,   1,    2,   6, 14,  7, 15,  3 });
-	uint8x8_t const st8b = vtbl2_u8(st7, (uint8x8_t) {  8,   9,   11,  10,  4, 12,  5, 13 });
-	uint8x8_t const st8min = vmin_u8(st8a, st8b); // [ 0], [ 1], [ 2],  3,  5,  7,  9, 11
-	uint8x8_t const st8max = vmax_u8(st8a, st8b); // [15], [14], [13],  4,  6,  8, 10, 12
-
-	// stage 9; done so far: 0, 1, 2, 3, 4, 5, 10, 11, 12, 13, 14, 15
-	uint8x8x2_t const st8 = { { st8min, st8max } };
-	uint8x8_t const st9a = vtbl2_u8(st8, (uint8x8_t) {  0,    1,    2,    3,   11,    4, 12, 13 });
-	uint8x8_t const st9b = vtbl2_u8(st8, (uint8x8_t) {  8,    9,   10,   15,    7,   14,  5,  6 });
-	uint8x8_t const st9min = vmin_u8(st9a, st9b); // [ 0], [ 1], [ 2], [ 3], [ 4], [ 5],  6,  8
-	uint8x8_t const st9max = vmax_u8(st9a, st9b); // [15], [14], [13], [12], [11], [10],  7,  9
-
-	uint8x16_t const st9 = vcombine_u8(st9min, st9max);
-	uint8x16_t const index = vqtbl1q_u8(st9, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 14, 7, 15, 13, 12, 11, 10, 9, 8 });
-
-	uint8x16_t const res = vqtbl1q_u8(vin, index);
-	vst1q_u8(output, res);
-	return sizeof(uint8x16_t) + int8_t(vaddvq_u8(bmask));
-}
-
-// pruner proper, 16-batch; replicates testee04/amd64
-inline size_t testee06() {
-	uint8x16_t const vin = vld1q_u8(input);
-	uint8x16_t const bmask = vcleq_u8(vin, vdupq_n_u8(' '));
-
-	// get the count of non-blanks for each 4-batch
-	uint8x16_t const cmask = vaddq_u8(bmask, vdupq_n_u8(1));
-	uint8x16_t const lena = vpaddq_u8(cmask, cmask);
-	uint8x16_t const lenb = vpaddq_u8(lena, lena);
-	size_t const len0 = vgetq_lane_u8(lenb, 0);
-	size_t const len1 = vgetq_lane_u8(lenb, 1);
-	size_t const len2 = vgetq_lane_u8(lenb, 2);
-	size_t const len3 = vgetq_lane_u8(lenb, 3);
-
-	// OR the mask of all blanks with the original index of the vector
-	uint8x16_t const risen = vorrq_u8(bmask, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
-
-	// now just sort that 'risen' to get the desired index of all non-blanks in the front, and all blanks in the back;
-	// an observation: we don't need to sort the entire risen index as a whole, we can sort it piece-wise
-
-	// 4-element sorting network: http://pages.ripco.net/~jgamble/nw.html -- 'Best version', 4 clusters of
-	//
-	//  [[0,1],[2,3]]  [[4,5],[6,7]]  [[8,9],[a,b]]  [[c,d],[e,f]]
-	//  [[0,2],[1,3]]  [[4,6],[5,7]]  [[8,a],[9,b]]  [[c,e],[d,f]]
-	//  [[1,2]]        [[5,6]]        [[9,a]]        [[d,e]]
-	//
-
-	uint8x8_t const st0a = vget_low_u8(vuzp1q_u8(risen, risen));
-	uint8x8_t const st0b = vget_low_u8(vuzp2q_u8(risen, risen));
-	uint8x8_t const st0min = vmin_u8(st0a, st0b); // 0, 2, 4, 6, 8, a, c, e
-	uint8x8_t const st0max = vmax_u8(st0a, st0b); // 1, 3, 5, 7, 9, b, d, f
-
-	uint8x8_t const st1a = vtrn1_u8(st0min, st0max);
-	uint8x8_t const st1b = vtrn2_u8(st0min, st0max);
-	uint8x8_t const st1min = vmin_u8(st1a, st1b); // 0, 1, 4, 5, 8, 9, c, d
-	uint8x8_t const st1max = vmax_u8(st1a, st1b); // 2, 3, 6, 7, a, b, e, f
-
-	uint8x8_t const st2a =           st1min;
-	uint8x8_t const st2b = vrev16_u8(st1max);
-	uint8x8_t const st2min = vmin_u8(st2a, st2b); // [0], 1, [4], 5, [8], 9, [c], d
-	uint8x8_t const st2max = vmax_u8(st2a, st2b); // [3], 2, [7], 6, [b], a, [f], e
-
-	uint8x16_t const index = vreinterpretq_u8_u16(vzip1q_u16(
-		vreinterpretq_u16_u8(vcombine_u8(          st2min,  vdup_n_u8(0))),
-		vreinterpretq_u16_u8(vcombine_u8(vrev16_u8(st2max), vdup_n_u8(0)))));
-
-	uint8x16_t const res = vqtbl1q_u8(vin, index);
-
-	*reinterpret_cast< uint32_t* >(output)                      = vgetq_lane_u32(vreinterpretq_u32_u8(res), 0);
-	*reinterpret_cast< uint32_t* >(output + len0)               = vgetq_lane_u32(vreinterpretq_u32_u8(res), 1);
-	*reinterpret_cast< uint32_t* >(output + len0 + len1)        = vgetq_lane_u32(vreinterpretq_u32_u8(res), 2);
-	*reinterpret_cast< uint32_t* >(output + len0 + len1 + len2) = vgetq_lane_u32(vreinterpretq_u32_u8(res), 3);
-	return len0 + len1 + len2 + len3;
-}
-
-// pruner proper, 32-batch; wider version of testee06
-inline size_t testee07() {
-	uint8x16_t const vin0 = vld1q_u8(input);
-	uint8x16_t const vin1 = vld1q_u8(input + sizeof(uint8x16_t));
-	uint8x16_t const bmask0 = vcleq_u8(vin0, vdupq_n_u8(' '));
-	uint8x16_t const bmask1 = vcleq_u8(vin1, vdupq_n_u8(' '));
-
-	// get the count of non-blanks for each 4-batch
-	uint8x16_t const cmask0 = vaddq_u8(bmask0, vdupq_n_u8(1));
-	uint8x16_t const cmask1 = vaddq_u8(bmask1, vdupq_n_u8(1));
-
-#if SAME_LATENCY_Q_AND_D
-	uint8x16_t const lena = vpaddq_u8(cmask0, cmask1);
-	uint8x16_t const lenb = vpaddq_u8(lena, lena);
-
-	size_t const len0 = vgetq_lane_u8(lenb, 0);
-	size_t const len1 = vgetq_lane_u8(lenb, 1);
-	size_t const len2 = vgetq_lane_u8(lenb, 2);
-	size_t const len3 = vgetq_lane_u8(lenb, 3);
-	size_t const len4 = vgetq_lane_u8(lenb, 4);
-	size_t const len5 = vgetq_lane_u8(lenb, 5);
-	size_t const len6 = vgetq_lane_u8(lenb, 6);
-	size_t const len7 = vgetq_lane_u8(lenb, 7);
-
-#else // when q-form of the instruction comes at extra latency (e.g. A72) use d-form instead, doubling the op count but utilizing co-issue for a net reduced latency
-	uint8x8_t const lena0 = vpadd_u8(vget_low_u8(cmask0), vget_high_u8(cmask0));
-	uint8x8_t const lena1 = vpadd_u8(vget_low_u8(cmask1), vget_high_u8(cmask1));
-	uint8x8_t const lenb0 = vpadd_u8(lena0, lena0);
-	uint8x8_t const lenb1 = vpadd_u8(lena1, lena1);
-
-	size_t const len0 = vget_lane_u8(lenb0, 0);
-	size_t const len1 = vget_lane_u8(lenb0, 1);
-	size_t const len2 = vget_lane_u8(lenb0, 2);
-	size_t const len3 = vget_lane_u8(lenb0, 3);
-	size_t const len4 = vget_lane_u8(lenb1, 0);
-	size_t const len5 = vget_lane_u8(lenb1, 1);
-	size_t const len6 = vget_lane_u8(lenb1, 2);
-	size_t const len7 = vget_lane_u8(lenb1, 3);
+// xorshift64, for reproducible inputs
+uint64_t random_state = 0x9e3779b97f4a7c15;
+
+uint64_t random_next(
+	uint64_t& state) {
+
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+
+uint64_t random_next() {
+	return random_next(random_state);
+}
+
+// prune src[0, len) in place at buf + offset, and check the result against the reference; chars past len must stay
+// untouched
+bool check_in_place(
+	prune_kernel const kernel,
+	uint8_t const* const src,
+	size_t const len,
+	size_t const offset,
+	uint8_t* const buf,
+	uint8_t* const ref) {
+
+	size_t const canary = 128;
+	memcpy(buf + offset, src, len);
+	memset(buf + offset + len, 0xa5, canary);
+
+	size_t const ref_len = reference(src, len, ref);
+	size_t const kept = prune_in_place(buf + offset, len, kernel);
+
+	bool ok = kept == ref_len && memcmp(buf + offset, ref, kept) == 0;
+	for (size_t i = 0; i < canary; ++i)
+		ok = ok && buf[offset + len + i] == 0xa5;
+
+	if (!ok)
+		fprintf(stderr, "error: %s in place, len %zu, offset %zu\n", prune_kernel_name(kernel), len, offset);
+	return ok;
+}
+
+// chars of the class checked below: some from each of the 16 rows of the 256-bit map, and either end of it
+char const class_chars[] = "\x01\x1f\t\n ,;@\\_`|\x7f\x80\x9f\xa0\xb7\xc2\xdd\xe2\xf0\xff";
+uint64_t const word0 = blank_word(0, class_chars);
+uint64_t const word1 = blank_word(1, class_chars);
+uint64_t const word2 = blank_word(2, class_chars);
+uint64_t const word3 = blank_word(3, class_chars);
+
+// check prune(), prune_parallel(), count_kept() and blank_bitmap() with the given predicate against the reference, over
+// random chars, mostly drawn from 'blanks' -- the predicate's blanks and their neighbours
+template < class blank >
+bool check_blank(
+	prune_kernel const kernel,
+	char const* const blanks,
+	char const* const name) {
+
+	size_t const len = (size_t(1) << 18) + 13;
+	size_t const blanks_len = strlen(blanks);
+	uint8_t* const src = static_cast< uint8_t* >(malloc(len));
+	uint8_t* const dst = static_cast< uint8_t* >(malloc(len));
+	uint8_t* const ref = static_cast< uint8_t* >(malloc(len));
+	uint64_t* const bits = static_cast< uint64_t* >(malloc((len + 63) / 64 * sizeof(uint64_t)));
+
+	for (size_t i = 0; i < len; ++i) {
+		uint64_t const r = random_next();
+		src[i] = r % 4 ? blanks[(r >> 8) % blanks_len] : r >> 16;
+	}
+
+	bool ok = true;
+
+	// the bitmap, bit by bit, and clear past n
+	auto const check_bitmap = [&](size_t const n) {
+		memset(bits, 0xa5, (n + 63) / 64 * sizeof(uint64_t));
+		blank_bitmap< blank >(src, n, bits, kernel);
+
+		bool bits_ok = true;
+		for (size_t i = 0; i < (n + 63) / 64 * 64; ++i)
+			bits_ok = bits_ok && (bits[i / 64] >> i % 64 & 1) == (i < n && !blank::scalar(src[i]));
+
+		return bits_ok;
+	};
+
+	// every length up to a few batches, then the entire buffer
+	for (size_t n = 0; n <= 4 * 64 + 1 && ok; ++n) {
+		size_t const ref_len = reference< blank >(src, n, ref);
+		ok = prune< blank >(src, n, dst, kernel) == ref_len && memcmp(dst, ref, ref_len) == 0;
+		ok = ok && count_kept< blank >(src, n, kernel) == ref_len && check_bitmap(n);
+	}
+
+	size_t const ref_len = reference< blank >(src, len, ref);
+	ok = ok && prune< blank >(src, len, dst, kernel) == ref_len && memcmp(dst, ref, ref_len) == 0;
+	ok = ok && prune_parallel< blank >(src, len, dst, 4, kernel) == ref_len && memcmp(dst, ref, ref_len) == 0;
+	ok = ok && count_kept< blank >(src, len, kernel) == ref_len && count_kept< blank >(src, len) == ref_len;
+	ok = ok && check_bitmap(len);
+
+	if (!ok)
+		fprintf(stderr, "error: %s with a %s predicate\n", prune_kernel_name(kernel), name);
+
+	free(bits);
+	free(ref);
+	free(dst);
+	free(src);
+	return ok;
+}
+
+// check prune_collapse() with the given predicate against the reference: every length up to a few batches, then the
+// entire buffer split in two at each of a range of places, with the run carried over, then once more in place
+template < class blank >
+bool check_collapse(
+	prune_kernel const kernel,
+	char const* const name) {
+
+	size_t const len = (size_t(1) << 16) + 13;
+	uint8_t* const src = static_cast< uint8_t* >(malloc(len));
+	uint8_t* const dst = static_cast< uint8_t* >(malloc(len));
+	uint8_t* const ref = static_cast< uint8_t* >(malloc(len));
+
+	// runs of all lengths, of all kinds of blanks, more so than single blanks
+	for (size_t i = 0; i < len; ++i) {
+		uint64_t const r = random_next();
+		src[i] = r % 3 ? " \t\n\r\x01\x1f"[(r >> 8) % 6] : 'a' + (r >> 16) % 26;
+	}
+
+	bool ok = true;
+
+	for (size_t n = 0; n <= 4 * 64 + 1 && ok; ++n) {
+		bool ref_run = false, run = false;
+		size_t const ref_len = reference_collapse< blank >(src, n, ref, ref_run);
+		ok = prune_collapse< blank >(src, n, dst, run, kernel) == ref_len && run == ref_run &&
+			memcmp(dst, ref, ref_len) == 0;
+	}
+
+	bool ref_run = false;
+	size_t const ref_len = reference_collapse< blank >(src, len, ref, ref_run);
+
+	for (size_t split = len / 2 - 70; split < len / 2 + 70 && ok; ++split) {
+		bool run = false;
+		size_t const head = prune_collapse< blank >(src, split, dst, run, kernel);
+		size_t const tail = prune_collapse< blank >(src + split, len - split, dst + head, run, kernel);
+		ok = head + tail == ref_len && run == ref_run && memcmp(dst, ref, ref_len) == 0;
+	}
+
+	bool run = false;
+	ok = ok && prune_collapse< blank >(src, len, src, run, kernel) == ref_len && memcmp(src, ref, ref_len) == 0;
+
+	if (!ok)
+		fprintf(stderr, "error: %s collapse with a %s predicate\n", prune_kernel_name(kernel), name);
+
+	free(ref);
+	free(dst);
+	free(src);
+	return ok;
+}
+
+// check prune_quoted() against the reference over random runs of quotes, backslashes and blanks: every length up to a
+// few blocks, then the entire buffer split in two at each of a range of places, with the state carried over, then
+// once more in place
+template < bool escapes >
+bool check_quoted(
+	prune_kernel const kernel,
+	char const* const name) {
+
+	size_t const len = (size_t(1) << 16) + 13;
+	uint8_t* const src = static_cast< uint8_t* >(malloc(len));
+	uint8_t* const dst = static_cast< uint8_t* >(malloc(len));
+	uint8_t* const ref = static_cast< uint8_t* >(malloc(len));
+
+	for (size_t i = 0; i < len; ) {
+		uint64_t const r = random_next();
+		size_t const run = 1 + (r >> 32) % 5;
+		uint8_t const c = "\"\\\\ \t\nab,:{"[r % 11];
+
+		for (size_t j = 0; j < run && i < len; ++j)
+			src[i++] = c;
+	}
+
+	bool ok = true;
+
+	for (size_t n = 0; n <= 4 * 64 + 1 && ok; ++n) {
+		bool in_string = false, escaped = false;
+		quote_state state = { 0, 0 };
+		size_t const ref_len = reference_quoted< escapes >(src, n, ref, in_string, escaped);
+		ok = prune_quoted< escapes >(src, n, dst, state, kernel) == ref_len && memcmp(dst, ref, ref_len) == 0 &&
+			(state.in_string != 0) == in_string && (state.escaped != 0) == escaped;
+	}
+
+	bool in_string = false, escaped = false;
+	size_t const ref_len = reference_quoted< escapes >(src, len, ref, in_string, escaped);
+
+	for (size_t split = len / 2 - 70; split < len / 2 + 70 && ok; ++split) {
+		quote_state state = { 0, 0 };
+		size_t const head = prune_quoted< escapes >(src, split, dst, state, kernel);
+		size_t const tail = prune_quoted< escapes >(src + split, len - split, dst + head, state, kernel);
+		ok = head + tail == ref_len && memcmp(dst, ref, ref_len) == 0;
+	}
+
+	quote_state state = { 0, 0 };
+	ok = ok && prune_quoted< escapes >(src, len, src, state, kernel) == ref_len && memcmp(src, ref, ref_len) == 0;
+
+	if (!ok)
+		fprintf(stderr, "error: %s quote-aware, %s\n", prune_kernel_name(kernel), name);
+
+	free(ref);
+	free(dst);
+	free(src);
+	return ok;
+}
+
+// UTF-8 to check with below: ASCII, sequences of 2, 3 and 4 chars, all kinds of Unicode blanks, and sequences a
+// char away from one; then ill-formed ones -- cut short, stray continuation chars, overlong forms, surrogates, and
+// code points past U+10FFFF
+char const* const utf8_tokens[] = {
+	"a", "Z", " ", "\t", "\n", "\xc3\xa9", "\xd0\x96", "\xe4\xb8\xad", "\xf0\x9f\x98\x80",
+	"\xc2\x85", "\xc2\xa0", "\xe1\x9a\x80", "\xe2\x80\x80", "\xe2\x80\x85", "\xe2\x80\x8a", "\xe2\x80\xa8",
+	"\xe2\x80\xa9", "\xe2\x80\xaf", "\xe2\x81\x9f", "\xe3\x80\x80",
+	"\xc2\x84", "\xc2\xa1", "\xe1\x9a\x81", "\xe2\x80\x8b", "\xe2\x80\xa7", "\xe2\x80\xae", "\xe2\x81\xa0",
+	"\xe3\x80\x81", "\xe2\x82\xac",
+	"\xe2\x80", "\xc2", "\x80", "\xc0\xaf", "\xe0\x80\x80", "\xed\xa0\x80", "\xf0\x80\x80\x80",
+	"\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xff"
+};
+size_t const utf8_well_formed = 29;
+
+// check prune_utf8() against the reference over random runs of the tokens above, well-formed or not: every length up
+// to a few blocks, then the entire buffer split in two at each of a range of places, with the state carried over, then
+// once more in place
+bool check_utf8(
+	prune_kernel const kernel,
+	bool const ill_formed,
+	char const* const name) {
+
+	size_t const len = (size_t(1) << 16) + 13;
+	size_t const tokens = ill_formed ? sizeof(utf8_tokens) / sizeof(utf8_tokens[0]) : utf8_well_formed;
+	uint8_t* const src = static_cast< uint8_t* >(malloc(len));
+	uint8_t* const dst = static_cast< uint8_t* >(malloc(len));
+	uint8_t* const ref = static_cast< uint8_t* >(malloc(len));
+
+	// mostly ASCII; a token that does not fit makes way for ASCII
+	for (size_t i = 0; i < len; ) {
+		uint64_t const r = random_next();
+		char const* const token = r % 4 ? utf8_tokens[(r >> 8) % tokens] : "x";
+		size_t const token_len = strlen(token);
+
+		if (i + token_len > len)
+			src[i++] = 'x';
+		else {
+			memcpy(src + i, token, token_len);
+			i += token_len;
+		}
+	}
+
+	bool ok = true;
+
+	for (size_t n = 0; n <= 4 * 64 + 1 && ok; ++n) {
+		bool ref_valid, valid;
+		size_t const ref_len = reference_utf8(src, n, ref, ref_valid);
+		ok = prune_utf8(src, n, dst, valid, kernel) == ref_len && memcmp(dst, ref, ref_len) == 0 && valid == ref_valid;
+	}
+
+	bool ref_valid;
+	size_t const ref_len = reference_utf8(src, len, ref, ref_valid);
+	ok = ok && ref_valid == !ill_formed;
+
+	for (size_t split = len / 2 - 70; split < len / 2 + 70 && ok; ++split) {
+		utf8_state state = { 0, 0, 0, 0, 0 };
+		bool valid;
+		size_t const head = prune_utf8(src, split, dst, state, kernel);
+		size_t const tail = prune_utf8(src + split, len - split, dst + head, state, kernel);
+		size_t const held = prune_utf8_finish(dst + head + tail, state, valid);
+		ok = head + tail + held == ref_len && memcmp(dst, ref, ref_len) == 0 && valid == ref_valid;
+	}
+
+	bool valid;
+	ok = ok && prune_utf8(src, len, src, valid, kernel) == ref_len && memcmp(src, ref, ref_len) == 0 && valid == ref_valid;
+
+	if (!ok)
+		fprintf(stderr, "error: %s UTF-8, %s\n", prune_kernel_name(kernel), name);
+
+	free(ref);
+	free(dst);
+	free(src);
+	return ok;
+}
+
+// check prune_stream() against the reference over buffers of many a staging buffer, at each alignment of dst modulo
+// a line, at varying prefetch distances; nothing but the non-blanks may get written
+bool check_stream(
+	prune_kernel const kernel) {
+
+	size_t const max_len = 16 * stream_stage + 13;
+	uint8_t* const src = static_cast< uint8_t* >(malloc(max_len));
+	uint8_t* const dst = static_cast< uint8_t* >(aligned_alloc(64, 64 + max_len + 64));
+	uint8_t* const ref = static_cast< uint8_t* >(malloc(max_len));
+
+	for (size_t i = 0; i < max_len; ++i) {
+		uint64_t const r = random_next();
+		src[i] = r % 4 == 0 ? " \t\n\r"[r >> 8 & 3] : 0x21 + (r >> 16) % 0xdf;
+	}
+
+	bool ok = true;
+
+	for (size_t offset = 0; offset < 64 && ok; ++offset) {
+		size_t const len = max_len - offset * 97;
+		size_t const ref_len = reference(src, len, ref);
+
+		memset(dst, 0xa5, 64 + max_len + 64);
+		ok = prune_stream(src, len, dst + offset, kernel, offset * 64) == ref_len &&
+			memcmp(dst + offset, ref, ref_len) == 0;
+
+		for (size_t i = 0; i < 64 + max_len + 64; ++i)
+			ok = ok && (dst[i] == 0xa5 || (i >= offset && i < offset + ref_len));
+	}
+
+	if (!ok)
+		fprintf(stderr, "error: %s streaming\n", prune_kernel_name(kernel));
+
+	free(ref);
+	free(dst);
+	free(src);
+	return ok;
+}
+
+// check prune_batch() against the reference over rounds of strings of random lengths, none at all to past a chunk of
+// the arena, pruned into the same arena: the outputs of a round must come one after the other, and those of earlier
+// rounds must stay put, until the arena is reset and reused
+template < class blank = blank_threshold<> >
+bool check_batch(
+	prune_kernel const kernel,
+	char const* const name) {
+
+	size_t const src_len = 4096;
+	size_t const rounds = 4;
+	size_t const n = 64;
+	uint8_t* const src = static_cast< uint8_t* >(malloc(src_len));
+	uint8_t* const ref = static_cast< uint8_t* >(malloc(300));
+	prune_view in[rounds][n], results[rounds][n];
+
+	for (size_t i = 0; i < src_len; ++i) {
+		uint64_t const r = random_next();
+		src[i] = r % 4 == 0 ? " \t\n\r"[r >> 8 & 3] : 0x21 + (r >> 16) % 0xdf;
+	}
+
+	for (size_t k = 0; k < rounds; ++k)
+		for (size_t s = 0; s < n; ++s) {
+			uint64_t const r = random_next();
+			size_t const len = r % 8 ? (r >> 8) % 300 : 0;
+			in[k][s].data = src + (r >> 32) % (src_len - len);
+			in[k][s].len = len;
+		}
+
+	prune_arena arena(256);
+	bool ok = true;
+
+	for (size_t pass = 0; pass < 2 && ok; ++pass) {
+		for (size_t k = 0; k < rounds && ok; ++k) {
+			size_t const len = prune_batch< blank >(in[k], n, arena, results[k], kernel);
+			size_t sum = 0;
+
+			for (size_t s = 0; s < n; ++s) {
+				ok = ok && (s == 0 || results[k][s].data == results[k][s - 1].data + results[k][s - 1].len);
+				sum += results[k][s].len;
+			}
+			ok = ok && sum == len;
+		}
+
+		for (size_t k = 0; k < rounds && ok; ++k)
+			for (size_t s = 0; s < n && ok; ++s) {
+				size_t const ref_len = reference< blank >(in[k][s].data, in[k][s].len, ref);
+				ok = results[k][s].len == ref_len && memcmp(results[k][s].data, ref, ref_len) == 0;
+			}
+
+		arena.reset();
+	}
+
+	if (!ok)
+		fprintf(stderr, "error: %s batch with a %s predicate\n", prune_kernel_name(kernel), name);
+
+	free(ref);
+	free(src);
+	return ok;
+}
+
+// check prune_in_place() of all pruners supported by the CPU at hand, with focus on the stores of a batch landing on the
+// very batch just read: no blanks at all keeps the output position glued to the input position, and blanks at the
+// ends of a batch move the overlapping partial stores around its edges; then check each kind of blank predicate, the
+// collapse of runs of blanks, the quote-aware pruning, the UTF-8 pruning, the streaming and the batches of strings
+int verify() {
+	size_t const max_len = 4 * 64 + 1;
+	uint8_t src[max_len];
+	uint8_t ref[max_len];
+	uint8_t buf[64 + max_len + 128] __attribute__ ((aligned(64)));
+	int ret = 0;
+
+	for (size_t k = 0; k < kernel_count; ++k) {
+		prune_kernel const kernel = prune_kernel(k);
+
+		if (!prune_supported(kernel))
+			continue;
+
+		bool ok = true;
+
+		for (size_t len = 0; len <= max_len; ++len)
+			for (size_t offset = 0; offset < 64; offset += 7) {
+				// no blanks
+				for (size_t i = 0; i < len; ++i)
+					src[i] = 'a' + i % 26;
+				ok = check_in_place(kernel, src, len, offset, buf, ref) && ok;
+
+				// a single blank, at each position
+				for (size_t b = 0; b < len; ++b) {
+					src[b] = ' ';
+					ok = check_in_place(kernel, src, len, offset, buf, ref) && ok;
+					src[b] = 'a' + b % 26;
+				}
+
+				// blanks at the ends of each 16-char lane
+				for (size_t i = 0; i < len; ++i)
+					src[i] = i % 16 == 0 || i % 16 == 15 ? ' ' : 'a' + i % 26;
+				ok = check_in_place(kernel, src, len, offset, buf, ref) && ok;
+
+				// random, at varying density of the blanks
+				for (size_t density = 1; density < 8; ++density) {
+					for (size_t i = 0; i < len; ++i) {
+						uint64_t const r = random_next();
+						src[i] = r % 8 < density ? " \t\n\r"[r >> 8 & 3] : 0x21 + (r >> 16) % 0xdf;
+					}
+					ok = check_in_place(kernel, src, len, offset, buf, ref) && ok;
+				}
+			}
+
+		ok = check_blank< blank_threshold< '9' > >(kernel, "0123456789:;<=>?", "threshold") && ok;
+		ok = check_blank< blank_set< ' ', '\t' > >(kernel, " \t\n\r", "set") && ok;
+		ok = check_blank< blank_set< '\r', '\n' > >(kernel, " \t\n\r", "set") && ok;
+		ok = check_blank< blank_class< word0, word1, word2, word3 > >(kernel, class_chars, "class") && ok;
+		ok = check_collapse< blank_threshold<> >(kernel, "threshold") && ok;
+		ok = check_collapse< blank_set< '\t', '\n' > >(kernel, "set") && ok;
+		ok = check_quoted< true >(kernel, "json") && ok;
+		ok = check_quoted< false >(kernel, "csv") && ok;
+		ok = check_utf8(kernel, false, "well-formed") && ok;
+		ok = check_utf8(kernel, true, "ill-formed") && ok;
+		ok = check_stream(kernel) && ok;
+		ok = check_batch< blank_threshold<> >(kernel, "threshold") && ok;
+		ok = check_batch< blank_set< '\r', '\n' > >(kernel, "set") && ok;
+
+		fprintf(stdout, "%s: %s\n", prune_kernel_name(kernel), ok ? "ok" : "FAILED");
+		if (!ok)
+			ret = 1;
+	}
+	return ret;
+}
+
+// Corpus generator, for timings on something other than the one input above: buffers of a given profile, from a
+// seeded PRNG so the runs are repeatable. The synthetic profile takes a target fraction of blanks and a mean length of
+// their runs -- runs of blanks and runs of non-blanks alike come at geometric lengths; the text profiles imitate source
+// code, logs, prose (in ASCII, or in UTF-8 with Unicode blanks) and pretty-printed JSON.
+enum corpus_kind {
+	corpus_input,  // the input of the perf sessions, repeated
+	corpus_blanks, // synthetic
+	corpus_source,
+	corpus_logs,
+	corpus_prose,
+	corpus_json,
+	corpus_utf8
+};
+
+struct corpus_profile {
+	corpus_kind kind;
+	double blank_fraction; // synthetic only: of all chars
+	double run_length;     // synthetic only: mean length of the runs of blanks
+	char name[48];
+};
+
+// appends to a buffer, dropping whatever does not fit
+struct corpus_writer {
+	uint8_t* buf;
+	size_t len;
+	size_t pos;
+	uint64_t state;
+
+	bool full() const {
+		return pos == len;
+	}
+
+	void put(
+		char const c) {
+
+		if (pos < len)
+			buf[pos++] = c;
+	}
+
+	void put(
+		char const* const str) {
+
+		for (size_t i = 0; str[i] != '\0'; ++i)
+			put(str[i]);
+	}
+
+	// uniform in [0, n)
+	size_t uniform(
+		size_t const n) {
+
+		return random_next(state) % n;
+	}
+
+	// geometric with the given mean, at least 1
+	size_t geometric(
+		double const mean) {
+
+		if (mean <= 1)
+			return 1;
+
+		double const u = ((random_next(state) >> 11) + 1) / 9007199254740992.0;
+		return 1 + size_t(log(u) / log(1 - 1 / mean));
+	}
+
+	void word(
+		size_t const len,
+		char const first,
+		size_t const range) {
+
+		for (size_t i = 0; i < len; ++i)
+			put(first + uniform(range));
+	}
+};
+
+void corpus_blanks_fill(
+	corpus_writer& w,
+	double const blank_fraction,
+	double const run_length) {
+
+	if (blank_fraction <= 0 || blank_fraction >= 1) {
+		while (!w.full())
+			w.put(blank_fraction <= 0 ? 0x21 + w.uniform(0x7f - 0x21) : ' ');
+		return;
+	}
+
+	// runs of non-blanks take the remaining fraction; past one blank per non-blank, the runs of blanks get longer
+	double blank_run = run_length;
+	double text_run = run_length * (1 - blank_fraction) / blank_fraction;
+
+	if (text_run < 1) {
+		text_run = 1;
+		blank_run = blank_fraction / (1 - blank_fraction);
+	}
+
+	// start at a random phase, so batches do not all begin on a text run
+	bool blank = w.uniform(2);
+
+	while (!w.full()) {
+		size_t const run = w.geometric(blank ? blank_run : text_run);
+
+		for (size_t i = 0; i < run; ++i)
+			w.put(blank ? ' ' : 0x21 + w.uniform(0x7f - 0x21));
+
+		blank = !blank;
+	}
+}
+
+void corpus_source_fill(
+	corpus_writer& w) {
+
+	static char const* const ops[] = { "=", "+", "-", "*", "<", "==", "!=", "&&", "->", "(", ")", "{", "}", ";", "," };
+	size_t depth = 0;
+
+	while (!w.full()) {
+		// one line in ten is empty
+		if (w.uniform(10) == 0) {
+			w.put('\n');
+			continue;
+		}
+
+		// indentation walks up and down a level at a time
+		size_t const step = w.uniform(4);
+		if (step == 0 && depth > 0)
+			--depth;
+		else if (step == 1 && depth < 6)
+			++depth;
+
+		for (size_t i = 0; i < depth * 4; ++i)
+			w.put(' ');
+
+		size_t const tokens = 1 + w.uniform(8);
+
+		for (size_t t = 0; t < tokens; ++t) {
+			if (t != 0)
+				w.put(' ');
+
+			if (w.uniform(3) == 0)
+				w.put(ops[w.uniform(sizeof(ops) / sizeof(ops[0]))]);
+			else
+				w.word(2 + w.uniform(10), 'a', 26);
+		}
+
+		// a trailing comment, now and then
+		if (w.uniform(8) == 0) {
+			w.put(" // ");
+			w.word(3 + w.uniform(20), 'a', 26);
+		}
+		w.put('\n');
+	}
+}
+
+void corpus_logs_fill(
+	corpus_writer& w) {
+
+	static char const* const levels[] = { "DEBUG", "INFO ", "INFO ", "INFO ", "WARN ", "ERROR" };
+	size_t msec = 0;
+
+	while (!w.full()) {
+		char stamp[64];
+		msec += w.uniform(2000);
+		snprintf(stamp, sizeof(stamp), "2024-05-01T%02zu:%02zu:%02zu.%03zuZ ",
+			msec / 3600000 % 24, msec / 60000 % 60, msec / 1000 % 60, msec % 1000);
+
+		w.put(stamp);
+		w.put(levels[w.uniform(sizeof(levels) / sizeof(levels[0]))]);
+		w.put(" [worker-");
+		w.put('0' + w.uniform(10));
+		w.put("] ");
+
+		size_t const words = 2 + w.uniform(8);
+
+		for (size_t i = 0; i < words; ++i) {
+			if (i != 0)
+				w.put(' ');
+
+			w.word(2 + w.uniform(8), 'a', 26);
+
+			// key=value pairs
+			if (w.uniform(3) == 0) {
+				w.put('=');
+				w.word(1 + w.uniform(8), '0', 10);
+			}
+		}
+		w.put('\n');
+	}
+}
+
+void corpus_prose_fill(
+	corpus_writer& w) {
+
+	size_t column = 0;
+	size_t sentences = 0;
+
+	while (!w.full()) {
+		size_t const words = 4 + w.uniform(20);
+
+		for (size_t i = 0; i < words; ++i) {
+			size_t const len = 1 + w.geometric(4);
+
+			// wrap at 72 columns
+			if (i != 0 && column + 1 + len > 72) {
+				w.put('\n');
+				column = 0;
+			}
+			else if (i != 0) {
+				w.put(' ');
+				++column;
+			}
+
+			w.put(i == 0 ? 'A' + w.uniform(26) : 'a' + w.uniform(26));
+			w.word(len - 1, 'a', 26);
+			column += len;
+
+			if (i + 1 != words && w.uniform(8) == 0) {
+				w.put(',');
+				++column;
+			}
+		}
+		w.put('.');
+		++column;
+
+		// paragraphs of a few sentences; two spaces after a period, as some would have it
+		if (++sentences % 5 == 0) {
+			w.put("\n\n");
+			column = 0;
+		}
+		else {
+			w.put(w.uniform(2) ? " " : "  ");
+			column += 2;
+		}
+	}
+}
+
+// prose past ASCII: sentences of words in Latin with accents, in Cyrillic or in CJK, parted by spaces, now and then
+// by no-break or thin ones, and by ideographic ones in CJK
+void corpus_utf8_fill(
+	corpus_writer& w) {
+
+	static char const* const latin[] = {
+		"a", "e", "i", "n", "r", "s", "t", "\xc3\xa9", "\xc3\xa8", "\xc3\xbc", "\xc3\xb1" };
+	static char const* const spaces[] = { " ", " ", " ", " ", " ", " ", "\xc2\xa0", "\xe2\x80\x89" };
+	size_t sentences = 0;
+
+	while (!w.full()) {
+		size_t const script = w.uniform(3);
+		size_t const words = 4 + w.uniform(16);
+
+		for (size_t i = 0; i < words; ++i) {
+			if (i != 0)
+				w.put(script == 2 && w.uniform(2) ? "\xe3\x80\x80" : spaces[w.uniform(8)]);
+
+			size_t const len = 1 + w.geometric(script == 2 ? 2 : 4);
+
+			for (size_t j = 0; j < len; ++j)
+				if (script == 0)
+					w.put(latin[w.uniform(11)]);
+				else if (script == 1) {
+					// U+0430 to U+044F
+					uint32_t const cp = 0x430 + w.uniform(32);
+					w.put(char(0xc0 | cp >> 6));
+					w.put(char(0x80 | (cp & 0x3f)));
+				}
+				else {
+					// U+4E00 to U+9FFF
+					uint32_t const cp = 0x4e00 + w.uniform(0x5200);
+					w.put(char(0xe0 | cp >> 12));
+					w.put(char(0x80 | (cp >> 6 & 0x3f)));
+					w.put(char(0x80 | (cp & 0x3f)));
+				}
+		}
+		w.put(script == 2 ? "\xe3\x80\x82" : ".");
+		w.put(++sentences % 5 == 0 ? "\n\n" : " ");
+	}
+}
+
+void corpus_json_value(
+	corpus_writer& w,
+	size_t const depth);
+
+void corpus_json_indent(
+	corpus_writer& w,
+	size_t const depth) {
+
+	w.put('\n');
+	for (size_t i = 0; i < depth * 2; ++i)
+		w.put(' ');
+}
+
+void corpus_json_value(
+	corpus_writer& w,
+	size_t const depth) {
+
+	// documents are objects, nesting up to 4 levels deep
+	size_t const kind = depth == 0 ? 0 : depth < 4 ? w.uniform(6) : 2 + w.uniform(4);
+
+	if (kind < 2) {
+		bool const object = kind == 0;
+		size_t const count = 1 + w.uniform(6);
+
+		w.put(object ? '{' : '[');
+
+		for (size_t i = 0; i < count && !w.full(); ++i) {
+			if (i != 0)
+				w.put(',');
+
+			corpus_json_indent(w, depth + 1);
+
+			if (object) {
+				w.put('"');
+				w.word(3 + w.uniform(10), 'a', 26);
+				w.put("\": ");
+			}
+			corpus_json_value(w, depth + 1);
+		}
+		corpus_json_indent(w, depth);
+		w.put(object ? '}' : ']');
+	}
+	else if (kind < 4) {
+		// strings, blanks and all
+		size_t const words = 1 + w.uniform(5);
+
+		w.put('"');
+		for (size_t i = 0; i < words; ++i) {
+			if (i != 0)
+				w.put(' ');
+
+			w.word(1 + w.uniform(9), 'a', 26);
+		}
+		w.put('"');
+	}
+	else if (kind == 4)
+		w.word(1 + w.uniform(7), '0', 10);
+	else
+		w.put(w.uniform(2) ? "true" : "null");
+}
+
+void corpus_json_fill(
+	corpus_writer& w) {
+
+	while (!w.full()) {
+		corpus_json_value(w, 0);
+		w.put('\n');
+	}
+}
+
+// fill buf[0, len) per the profile, from the given seed
+void corpus_fill(
+	uint8_t* const buf,
+	size_t const len,
+	corpus_profile const& profile,
+	uint64_t const seed) {
+
+	corpus_writer w = { buf, len, 0, seed | 1 };
+
+	switch (profile.kind) {
+	case corpus_blanks:
+		corpus_blanks_fill(w, profile.blank_fraction, profile.run_length);
+		break;
+	case corpus_source:
+		corpus_source_fill(w);
+		break;
+	case corpus_logs:
+		corpus_logs_fill(w);
+		break;
+	case corpus_prose:
+		corpus_prose_fill(w);
+		break;
+	case corpus_json:
+		corpus_json_fill(w);
+		break;
+	case corpus_utf8:
+		corpus_utf8_fill(w);
+		break;
+	default:
+		for (size_t i = 0; i < len; ++i)
+			buf[i] = input[i % 32];
+		break;
+	}
+}
+
+// parse a comma-separated list of profiles: input, source, logs, prose, json, utf8, blanks:P[:R] (P percent of blanks
+// in runs of mean length R, 1 by default), density[:R] (blanks:0 to blanks:100 in steps of 10), all (each of the text
+// profiles, then density:1 and density:4); false on a bad list
+bool corpus_parse(
+	char const* const list,
+	std::vector< corpus_profile >& profiles) {
+
+	static char const* const text[] = { "input", "source", "logs", "prose", "json", "utf8" };
+	static corpus_kind const text_kind[] = {
+		corpus_input, corpus_source, corpus_logs, corpus_prose, corpus_json, corpus_utf8 };
+
+	char const* item = list;
+
+	while (*item != '\0') {
+		size_t const len = strcspn(item, ",");
+		bool known = false;
+
+		for (size_t i = 0; i < sizeof(text) / sizeof(text[0]); ++i)
+			if (len == strlen(text[i]) && strncmp(item, text[i], len) == 0) {
+				corpus_profile profile = { text_kind[i], 0, 0, "" };
+				snprintf(profile.name, sizeof(profile.name), "%s", text[i]);
+				profiles.push_back(profile);
+				known = true;
+			}
+
+		double percent, run_length = 1;
+		char* end;
+
+		if (len == strlen("all") && strncmp(item, "all", len) == 0) {
+			if (!corpus_parse("input,source,logs,prose,json,utf8,density:1,density:4", profiles))
+				return false;
+			known = true;
+		}
+		else if (strncmp(item, "blanks:", strlen("blanks:")) == 0) {
+			percent = strtod(item + strlen("blanks:"), &end);
+			if (*end == ':')
+				run_length = strtod(end + 1, &end);
+
+			if (end != item + len || percent < 0 || percent > 100 || run_length < 1)
+				return false;
+
+			corpus_profile profile = { corpus_blanks, percent / 100, run_length, "" };
+			snprintf(profile.name, sizeof(profile.name), "blanks:%g:%g", percent, run_length);
+			profiles.push_back(profile);
+			known = true;
+		}
+		else if (strncmp(item, "density", strlen("density")) == 0) {
+			end = const_cast< char* >(item) + strlen("density");
+			if (*end == ':')
+				run_length = strtod(end + 1, &end);
+
+			if (end != item + len || run_length < 1)
+				return false;
+
+			for (size_t p = 0; p <= 100; p += 10) {
+				corpus_profile profile = { corpus_blanks, p / 100., run_length, "" };
+				snprintf(profile.name, sizeof(profile.name), "blanks:%zu:%g", p, run_length);
+				profiles.push_back(profile);
+			}
+			known = true;
+		}
+
+		if (!known)
+			return false;
+
+		item += len;
+		if (*item == ',')
+			++item;
+	}
+	return true;
+}
+
+// write a corpus of the given profile and KiB to stdout, e.g. as input to ascii_prune
+int corpus(
+	char const* const name,
+	size_t const kib,
+	uint64_t const seed) {
+
+	std::vector< corpus_profile > profiles;
+
+	if (!corpus_parse(name, profiles) || profiles.size() != 1) {
+		fprintf(stderr, "error: bad profile '%s'\n", name);
+		return 2;
+	}
+
+	std::vector< uint8_t > buf(kib << 10);
+	corpus_fill(buf.data(), buf.size(), profiles[0], seed);
+
+	return fwrite(buf.data(), 1, buf.size(), stdout) == buf.size() ? 0 : 1;
+}
+
+// Self-timing harness: every testee the CPU at hand supports, each over the L1-resident input batch in the manner of
+// the perf sessions in README.md, for a number of trials after a warmup. Per trial, cycles and instructions come from
+// the PMU via perf_event_open, where the kernel permits that (see perf_event_paranoid), and wall time regardless.
+
+// timed loop of a testee, batch by batch over src[0, len) into dst, reps times over; the ISA-targeted variants let the
+// testee inline into the loop
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*) >
+__attribute__ ((always_inline)) inline void bench_loop(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const reps) {
+
+	for (size_t r = 0; r < reps; ++r) {
+		uint8_t* out = dst;
+
+		for (size_t i = 0; i + batch <= len; i += batch) {
+			out += testee(src + i, out);
+			// iteration obfuscator
+			asm volatile ("" : : : "memory");
+		}
+	}
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*) >
+void bench_run(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const reps) {
+
+	bench_loop< batch, testee >(src, len, dst, reps);
+}
+
+#if __x86_64__ || __i386__
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*) >
+PRUNER_TARGET_SSSE3 void bench_run_ssse3(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const reps) {
+
+	bench_loop< batch, testee >(src, len, dst, reps);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*) >
+PRUNER_TARGET_AVX2 void bench_run_avx2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const reps) {
+
+	bench_loop< batch, testee >(src, len, dst, reps);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*) >
+PRUNER_TARGET_AVX512VBMI2 void bench_run_avx512vbmi2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const reps) {
+
+	bench_loop< batch, testee >(src, len, dst, reps);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*) >
+PRUNER_TARGET_SSE2 void bench_run_sse2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const reps) {
+
+	bench_loop< batch, testee >(src, len, dst, reps);
+}
+
+template < size_t batch, size_t (& testee)(uint8_t const*, uint8_t*) >
+PRUNER_TARGET_BMI2 void bench_run_bmi2(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const reps) {
+
+	bench_loop< batch, testee >(src, len, dst, reps);
+}
 
 #endif
-	// OR the mask of all blanks with the original index of the vector
-	uint8x16_t const risen0 = vorrq_u8(bmask0, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
-	uint8x16_t const risen1 = vorrq_u8(bmask1, (uint8x16_t) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
+// an adaptive testee as a batch testee, its counters left to the compiler to drop
+template < size_t (& testee)(uint8_t const*, uint8_t*, prune_paths&) >
+__attribute__ ((always_inline)) inline size_t bench_adaptive(
+	uint8_t const* const input,
+	uint8_t* const output) {
+
+	prune_paths paths = { 0, 0, 0, 0, 0 };
+	return testee(input, output, paths);
+}
+
+// offsets of the position testees, which the harness of the batch testees knows nothing of: those of each batch go
+// to the index of its chars in the output, wrapped around the scratch; the base is the offset of the batch in the input
+size_t const bench_positions_len = size_t(1) << 20;
+uint32_t bench_positions[bench_positions_len + 64];
+uint8_t const* bench_input;
+uint8_t const* bench_output;
+
+// a position testee as a batch testee
+template < size_t (& testee)(uint8_t const*, uint8_t*, uint32_t*, uint32_t) >
+__attribute__ ((always_inline)) inline size_t bench_position(
+	uint8_t const* const input,
+	uint8_t* const output) {
+
+	return testee(input, output, bench_positions + (size_t(output - bench_output) & (bench_positions_len - 1)),
+		uint32_t(input - bench_input));
+}
+
+// a UTF-8 testee as a batch testee, from a fresh state each batch
+template < size_t (& testee)(uint8_t const*, uint8_t*, utf8_state&) >
+__attribute__ ((always_inline)) inline size_t bench_utf8(
+	uint8_t const* const input,
+	uint8_t* const output) {
+
+	utf8_state state = { 0, 0, 0, 0, 0 };
+	return testee(input, output, state);
+}
+
+// the scalar UTF-8 version over a batch of 64, the reference of the ones above
+inline size_t bench_utf8_00(
+	uint8_t const* const input,
+	uint8_t* const output) {
+
+	utf8_state state = { 0, 0, 0, 0, 0 };
+	return utf8_00< blank_threshold<> >(input, 64, output, state);
+}
+
+// the streaming driver of the given pruner over all of the corpus at once, rather than a batch testee in the loop of
+// the harness; -f sets its prefetch distance
+size_t bench_prefetch = PRUNER_PREFETCH_DISTANCE;
+
+template < prune_kernel kernel >
+void bench_stream(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const reps) {
+
+	for (size_t r = 0; r < reps; ++r) {
+		prune_stream(src, len, dst, kernel, bench_prefetch);
+		asm volatile ("" : : : "memory");
+	}
+}
+
+// short fields for the batch API: the corpus cut into strings of 8 to 200 chars, anew for each corpus
+std::vector< prune_view > bench_views;
+std::vector< prune_view > bench_results;
+uint8_t const* bench_views_src;
+size_t bench_views_len;
 
-	// now just sort that 'risen' to get the desired index of all non-blanks in the front, and all blanks in the back;
-	// an observation: we don't need to sort the entire risen index as a whole, we can sort it piece-wise
+void bench_cut(
+	uint8_t const* const src,
+	size_t const len) {
 
-	// 4-element sorting network: http://pages.ripco.net/~jgamble/nw.html -- 'Best version', 4 clusters of
-	//
-	//  [[0,1],[2,3]]  [[4,5],[6,7]]  [[8,9],[a,b]]  [[c,d],[e,f]]
-	//  [[0,2],[1,3]]  [[4,6],[5,7]]  [[8,a],[9,b]]  [[c,e],[d,f]]
-	//  [[1,2]]        [[5,6]]        [[9,a]]        [[d,e]]
-	//
+	if (src == bench_views_src && len == bench_views_len)
+		return;
 
-	uint8x16_t const st0a = vuzp1q_u8(risen0, risen1);
-	uint8x16_t const st0b = vuzp2q_u8(risen0, risen1);
-	uint8x16_t const st0min = vminq_u8(st0a, st0b); // 0, 2, 4, 6, 8, a, c, e
-	uint8x16_t const st0max = vmaxq_u8(st0a, st0b); // 1, 3, 5, 7, 9, b, d, f
+	uint64_t state = len | 1;
+	bench_views.clear();
 
-	uint8x16_t const st1a = vtrn1q_u8(st0min, st0max);
-	uint8x16_t const st1b = vtrn2q_u8(st0min, st0max);
-	uint8x16_t const st1min = vminq_u8(st1a, st1b); // 0, 1, 4, 5, 8, 9, c, d
-	uint8x16_t const st1max = vmaxq_u8(st1a, st1b); // 2, 3, 6, 7, a, b, e, f
+	for (size_t i = 0; i < len; ) {
+		size_t field = 8 + random_next(state) % 193;
+		field = field < len - i ? field : len - i;
 
-	uint8x16_t const st2a =            st1min;
-	uint8x16_t const st2b = vrev16q_u8(st1max);
-	uint8x16_t const st2min = vminq_u8(st2a, st2b); // [0], 1, [4], 5, [8], 9, [c], d
-	uint8x16_t const st2max = vmaxq_u8(st2a, st2b); // [3], 2, [7], 6, [b], a, [f], e
+		prune_view const view = { src + i, field };
+		bench_views.push_back(view);
+		i += field;
+	}
+
+	bench_results.resize(bench_views.size());
+	bench_views_src = src;
+	bench_views_len = len;
+}
+
+// a driver of prune_batch() over the fields of the corpus, into dst
+template < size_t (& views)(prune_view const*, size_t, uint8_t*, prune_view*) >
+void bench_batch(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const reps) {
+
+	bench_cut(src, len);
 
-	uint16x8_t const stx = vreinterpretq_u16_u8(           st2min );
-	uint16x8_t const sty = vreinterpretq_u16_u8(vrev16q_u8(st2max));
+	for (size_t r = 0; r < reps; ++r) {
+		views(bench_views.data(), bench_views.size(), dst, bench_results.data());
+		asm volatile ("" : : : "memory");
+	}
+}
 
-	uint8x16_t const index0 = vreinterpretq_u8_u16(vzip1q_u16(stx, sty));
-	uint8x16_t const index1 = vreinterpretq_u8_u16(vzip2q_u16(stx, sty));
+// what prune_batch() does away with: a call of prune() per field
+template < prune_kernel kernel >
+void bench_fields(
+	uint8_t const* const src,
+	size_t const len,
+	uint8_t* const dst,
+	size_t const reps) {
 
-	uint8x16_t const res0 = vqtbl1q_u8(vin0, index0);
-	uint8x16_t const res1 = vqtbl1q_u8(vin1, index1);
+	bench_cut(src, len);
 
-	// note: following len cascade is a prime candidate for implementation via prefix sum, but so far the scalar additions pipeline well
-	*reinterpret_cast< uint32_t* >(output)                                                  = vgetq_lane_u32(vreinterpretq_u32_u8(res0), 0);
-	*reinterpret_cast< uint32_t* >(output + len0)                                           = vgetq_lane_u32(vreinterpretq_u32_u8(res0), 1);
-	*reinterpret_cast< uint32_t* >(output + len0 + len1)                                    = vgetq_lane_u32(vreinterpretq_u32_u8(res0), 2);
-	*reinterpret_cast< uint32_t* >(output + len0 + len1 + len2)                             = vgetq_lane_u32(vreinterpretq_u32_u8(res0), 3);
+	for (size_t r = 0; r < reps; ++r) {
+		uint8_t* out = dst;
 
-	*reinterpret_cast< uint32_t* >(output + len0 + len1 + len2 + len3)                      = vgetq_lane_u32(vreinterpretq_u32_u8(res1), 0);
-	*reinterpret_cast< uint32_t* >(output + len0 + len1 + len2 + len3 + len4)               = vgetq_lane_u32(vreinterpretq_u32_u8(res1), 1);
-	*reinterpret_cast< uint32_t* >(output + len0 + len1 + len2 + len3 + len4 + len5)        = vgetq_lane_u32(vreinterpretq_u32_u8(res1), 2);
-	*reinterpret_cast< uint32_t* >(output + len0 + len1 + len2 + len3 + len4 + len5 + len6) = vgetq_lane_u32(vreinterpretq_u32_u8(res1), 3);
+		for (size_t i = 0; i < bench_views.size(); ++i)
+			out += prune(bench_views[i].data, bench_views[i].len, out, kernel);
 
-	return len0 + len1 + len2 + len3 + len4 + len5 + len6 + len7;
+		asm volatile ("" : : : "memory");
+	}
 }
 
+// all testees, for the timings and the differential checks
+struct bench_testee {
+	char const* name;
+	size_t batch;
+	prune_kernel isa;       // a pruner of the same ISA extensions, to check the CPU with
+	size_t interior_blanks; // most blanks ahead of the trailing run of blanks of each 16 chars it gets right; 16: all
+	size_t (* testee)(uint8_t const*, uint8_t*);
+	void (* run)(uint8_t const*, size_t, uint8_t*, size_t);
+	size_t (* reference)(uint8_t const*, uint8_t*); // to check it against, a batch at a time; NULL: testee00
+};
+
+bench_testee const bench_testees[] = {
+	{ "testee00", 16, kernel_testee00, 16, testee00<>, bench_run< 16, testee00<> >, NULL },
+	{ "testee17", 16, kernel_testee17, 16, testee17, bench_run< 16, testee17 >, NULL },
+	{ "positions00", 16, kernel_testee00, 16, bench_position< positions00< blank_threshold<> > >,
+		bench_run< 16, bench_position< positions00< blank_threshold<> > > >, NULL },
+#if __aarch64__
+	{ "testee01", 16, kernel_testee06, 1, testee01, bench_run< 16, testee01 >, NULL },
+	{ "testee02", 32, kernel_testee06, 1, testee02, bench_run< 32, testee02 >, NULL },
+	{ "testee04", 16, kernel_testee06, 16, testee04<>, bench_run< 16, testee04<> >, NULL },
+	{ "testee05", 16, kernel_testee06, 16, testee05<>, bench_run< 16, testee05<> >, NULL },
+	{ "testee06", 16, kernel_testee06, 16, testee06<>, bench_run< 16, testee06<> >, NULL },
+	{ "testee07", 32, kernel_testee07, 16, testee07< true >, bench_run< 32, testee07< true > >, NULL },
+	{ "testee07_a72", 32, kernel_testee07_a72, 16, testee07< false >, bench_run< 32, testee07< false > >, NULL },
+	{ "stream07", 32, kernel_testee07, 16, testee07< true >, bench_stream< kernel_testee07 >, NULL },
+	{ "fields07", 32, kernel_testee07, 16, testee07< true >, bench_fields< kernel_testee07 >, NULL },
+	{ "batch06", 16, kernel_testee06, 16, testee06<>, bench_batch< prune_views< 16, testee06<>, blank_threshold<> > >,
+		NULL },
+	{ "batch07", 32, kernel_testee07, 16, testee07< true >,
+		bench_batch< prune_views< 32, testee07< true >, blank_threshold<> > >, NULL },
+	{ "adaptive07", 64, kernel_testee07, 16, bench_adaptive< adaptive07< true, blank_threshold<> > >,
+		bench_run< 64, bench_adaptive< adaptive07< true, blank_threshold<> > > >, NULL },
+	{ "utf8_07", 64, kernel_testee07, 16, bench_utf8< utf8_07< true, blank_threshold<> > >,
+		bench_run< 64, bench_utf8< utf8_07< true, blank_threshold<> > > >, bench_utf8_00 },
+	{ "testee11", 16, kernel_testee06, 16, testee11<>, bench_run< 16, testee11<> >, NULL },
+	{ "testee11_batcher", 16, kernel_testee06, 16, testee11< network_batcher< 16 > >,
+		bench_run< 16, testee11< network_batcher< 16 > > >, NULL },
+	{ "testee11_bitonic", 16, kernel_testee06, 16, testee11< network_bitonic< 16 > >,
+		bench_run< 16, testee11< network_bitonic< 16 > > >, NULL },
+	{ "positions11", 16, kernel_testee06, 16, bench_position< positions11< blank_threshold<> > >,
+		bench_run< 16, bench_position< positions11< blank_threshold<> > > >, NULL },
+	{ "testee14_8", 16, kernel_testee06, 16, testee14< 8 >, bench_run< 16, testee14< 8 > >, NULL },
+	{ "testee14_12", 16, kernel_testee06, 16, testee14< 12 >, bench_run< 16, testee14< 12 > >, NULL },
+	{ "testee14_16", 16, kernel_testee06, 16, testee14< 16 >, bench_run< 16, testee14< 16 > >, NULL },
 #if defined(__ARM_FEATURE_SVE)
-// scatter-enabled version of testee01, 64-batch on sve512
-inline size_t testee08() {
-	svbool_t const pr = svptrue_pat_b8(SV_VL64); // assumed at least sve512
+	{ "testee08", 64, kernel_testee08, 16, testee08, bench_run< 64, testee08 >, NULL },
+#endif
+#elif __x86_64__ || __i386__
+	{ "testee01", 16, kernel_testee04, 1, testee01, bench_run_ssse3< 16, testee01 >, NULL },
+	{ "testee02", 32, kernel_testee04, 1, testee02, bench_run_ssse3< 32, testee02 >, NULL },
+	{ "testee03", 16, kernel_testee04, 0, testee03, bench_run_ssse3< 16, testee03 >, NULL },
+	{ "testee04", 16, kernel_testee04, 16, testee04<>, bench_run_ssse3< 16, testee04<> >, NULL },
+	{ "testee16", 16, kernel_testee16, 16, testee16, bench_run_sse2< 16, testee16 >, NULL },
+	{ "testee05", 16, kernel_testee05, 16, testee05<>, bench_run_ssse3< 16, testee05<> >, NULL },
+	{ "testee09", 32, kernel_testee09, 16, testee09<>, bench_run_avx2< 32, testee09<> >, NULL },
+	{ "testee10", 64, kernel_testee10, 16, testee10<>, bench_run_avx512vbmi2< 64, testee10<> >, NULL },
+#if __x86_64__
+	{ "testee15", 32, kernel_testee15, 16, testee15<>, bench_run_bmi2< 32, testee15<> >, NULL },
+#endif
+	{ "stream04", 16, kernel_testee04, 16, testee04<>, bench_stream< kernel_testee04 >, NULL },
+	{ "stream09", 32, kernel_testee09, 16, testee09<>, bench_stream< kernel_testee09 >, NULL },
+	{ "stream10", 64, kernel_testee10, 16, testee10<>, bench_stream< kernel_testee10 >, NULL },
+	{ "fields04", 16, kernel_testee04, 16, testee04<>, bench_fields< kernel_testee04 >, NULL },
+	{ "fields10", 64, kernel_testee10, 16, testee10<>, bench_fields< kernel_testee10 >, NULL },
+	{ "batch04", 16, kernel_testee04, 16, testee04<>,
+		bench_batch< prune_views_ssse3< 16, testee04<>, blank_threshold<> > >, NULL },
+	{ "batch05", 16, kernel_testee05, 16, testee05<>,
+		bench_batch< prune_views_ssse3< 16, testee05<>, blank_threshold<> > >, NULL },
+	{ "batch09", 32, kernel_testee09, 16, testee09<>,
+		bench_batch< prune_views_avx2< 32, testee09<>, blank_threshold<> > >, NULL },
+	{ "batch10", 64, kernel_testee10, 16, testee10<>, bench_batch< prune_views10< blank_threshold<> > >, NULL },
+#if __x86_64__
+	{ "batch15", 32, kernel_testee15, 16, testee15<>,
+		bench_batch< prune_views_bmi2< 32, testee15<>, blank_threshold<> > >, NULL },
+#endif
+	{ "testee11", 16, kernel_testee04, 16, testee11<>, bench_run_ssse3< 16, testee11<> >, NULL },
+	{ "testee11_batcher", 16, kernel_testee04, 16, testee11< network_batcher< 16 > >,
+		bench_run_ssse3< 16, testee11< network_batcher< 16 > > >, NULL },
+	{ "testee11_bitonic", 16, kernel_testee04, 16, testee11< network_bitonic< 16 > >,
+		bench_run_ssse3< 16, testee11< network_bitonic< 16 > > >, NULL },
+	{ "positions11", 16, kernel_testee04, 16, bench_position< positions11< blank_threshold<> > >,
+		bench_run_ssse3< 16, bench_position< positions11< blank_threshold<> > > >, NULL },
+	{ "positions12", 32, kernel_testee09, 16, bench_position< positions12< blank_threshold<> > >,
+		bench_run_avx2< 32, bench_position< positions12< blank_threshold<> > > >, NULL },
+	{ "positions10", 64, kernel_testee10, 16, bench_position< positions10< blank_threshold<> > >,
+		bench_run_avx512vbmi2< 64, bench_position< positions10< blank_threshold<> > > >, NULL },
+	{ "testee14_8", 16, kernel_testee04, 16, testee14< 8 >, bench_run_ssse3< 16, testee14< 8 > >, NULL },
+	{ "testee14_12", 16, kernel_testee04, 16, testee14< 12 >, bench_run_ssse3< 16, testee14< 12 > >, NULL },
+	{ "testee14_16", 16, kernel_testee04, 16, testee14< 16 >, bench_run_ssse3< 16, testee14< 16 > >, NULL },
+	{ "testee12", 32, kernel_testee09, 16, testee12<>, bench_run_avx2< 32, testee12<> >, NULL },
+	{ "testee13", 64, kernel_testee10, 16, testee13<>, bench_run_avx512vbmi2< 64, testee13<> >, NULL },
+	{ "testee13_batcher", 64, kernel_testee10, 16, testee13< network_batcher< 64 > >,
+		bench_run_avx512vbmi2< 64, testee13< network_batcher< 64 > > >, NULL },
+	{ "adaptive04", 64, kernel_testee04, 16, bench_adaptive< adaptive04< blank_threshold<> > >,
+		bench_run_ssse3< 64, bench_adaptive< adaptive04< blank_threshold<> > > >, NULL },
+	{ "adaptive09", 64, kernel_testee09, 16, bench_adaptive< adaptive09< blank_threshold<> > >,
+		bench_run_avx2< 64, bench_adaptive< adaptive09< blank_threshold<> > > >, NULL },
+	{ "adaptive10", 64, kernel_testee10, 16, bench_adaptive< adaptive10< blank_threshold<> > >,
+		bench_run_avx512vbmi2< 64, bench_adaptive< adaptive10< blank_threshold<> > > >, NULL },
+	{ "utf8_04", 64, kernel_testee04, 16, bench_utf8< utf8_04< blank_threshold<> > >,
+		bench_run_ssse3< 64, bench_utf8< utf8_04< blank_threshold<> > > >, bench_utf8_00 },
+	{ "utf8_09", 64, kernel_testee09, 16, bench_utf8< utf8_09< blank_threshold<> > >,
+		bench_run_avx2< 64, bench_utf8< utf8_09< blank_threshold<> > > >, bench_utf8_00 },
+	{ "utf8_10", 64, kernel_testee10, 16, bench_utf8< utf8_10< blank_threshold<> > >,
+		bench_run_avx512vbmi2< 64, bench_utf8< utf8_10< blank_threshold<> > > >, bench_utf8_00 },
+#endif
+};
 
-	svuint8_t const vinput = svld1_u8(pr, input);
-	svbool_t const pr_keep = svcmpgt_n_u8(pr, vinput, ' ');
-	size_t const kept = svcntp_b8(pr_keep, pr_keep);
+// Differential checks of the raw testees against testee00: each 16 chars of a batch take all 2^16 masks of blanks in
+// turn, the rest of the batch random masks, with random blanks (any char up to ' ') and random non-blanks (any char
+// past it, high ones included). The testees documented as right only for some masks of blanks -- testee01/02 for a
+// single blank ahead of the trailing blanks, testee03 for trailing blanks alone -- must be right on those, and get
+// their mismatches elsewhere counted; the rest of their batch keeps to those masks. The UTF-8 testees go against their
+// scalar version instead, the high chars among the non-blanks making for ill-formed UTF-8 of all sorts.
 
-	// prefix sum of to-keep mask
-	svuint8_t prfsum = svdup_n_u8_z(pr_keep, 1);
-	prfsum = svadd_u8_x(pr, prfsum, svext_u8(svdup_n_u8(0), prfsum, 64 -  1)); // assumed exactly sve512
-	prfsum = svadd_u8_x(pr, prfsum, svext_u8(svdup_n_u8(0), prfsum, 64 -  2)); // TODO: possible to use with VLEN?
-	prfsum = svadd_u8_x(pr, prfsum, svext_u8(svdup_n_u8(0), prfsum, 64 -  4));
-	prfsum = svadd_u8_x(pr, prfsum, svext_u8(svdup_n_u8(0), prfsum, 64 -  8));
-	prfsum = svadd_u8_x(pr, prfsum, svext_u8(svdup_n_u8(0), prfsum, 64 - 16));
-	prfsum = svadd_u8_x(pr, prfsum, svext_u8(svdup_n_u8(0), prfsum, 64 - 32));
-	prfsum = svsub_u8_x(pr, prfsum, svdup_n_u8(1)); // 0-based prefix sum
+// blanks ahead of the trailing run of blanks in a 16-bit mask
+size_t interior_blanks(
+	uint32_t const mask) {
 
-	// 8-bit pred -> 32-bit pred
-	svbool_t const pr_keep0 = svunpklo_b(svunpklo_b(pr_keep)); // - - - +
-	svbool_t const pr_keep1 = svunpkhi_b(svunpklo_b(pr_keep)); // - - + -
-	svbool_t const pr_keep2 = svunpklo_b(svunpkhi_b(pr_keep)); // - + - -
-	svbool_t const pr_keep3 = svunpkhi_b(svunpkhi_b(pr_keep)); // + - - -
+	uint32_t trailing = 0;
+	while (trailing < 16 && mask >> (15 - trailing) & 1)
+		++trailing;
 
-	// 8-bit chars -> 32-bit chars
-	svuint32_t const winput0 = svunpklo_u32(svunpklo_u16(vinput));
-	svuint32_t const winput1 = svunpkhi_u32(svunpklo_u16(vinput));
-	svuint32_t const winput2 = svunpklo_u32(svunpkhi_u16(vinput));
-	svuint32_t const winput3 = svunpkhi_u32(svunpkhi_u16(vinput));
+	return __builtin_popcount(mask) - trailing;
+}
 
-	// 8-bit offsets -> 32-bit offsets
-	svuint32_t const woffset0 = svunpklo_u32(svunpklo_u16(prfsum));
-	svuint32_t const woffset1 = svunpkhi_u32(svunpklo_u16(prfsum));
-	svuint32_t const woffset2 = svunpklo_u32(svunpkhi_u16(prfsum));
-	svuint32_t const woffset3 = svunpkhi_u32(svunpkhi_u16(prfsum));
+// a random 16-bit mask of blanks, with at most the given count of blanks ahead of the trailing ones
+uint32_t random_mask(
+	uint64_t& state,
+	size_t const interior) {
 
-	if (svptest_any(pr_keep0, pr_keep0))
-		svst1b_scatter_offset(pr_keep0, output, woffset0, winput0);
+	uint64_t const r = random_next(state);
 
-	if (svptest_any(pr_keep1, pr_keep1))
-		svst1b_scatter_offset(pr_keep1, output, woffset1, winput1);
+	if (interior >= 16)
+		return r & 0xffff;
 
-	if (svptest_any(pr_keep2, pr_keep2))
-		svst1b_scatter_offset(pr_keep2, output, woffset2, winput2);
+	size_t const trailing = r % 17;
+	uint32_t mask = 0xffff0000 >> trailing & 0xffff;
 
-	if (svptest_any(pr_keep3, pr_keep3))
-		svst1b_scatter_offset(pr_keep3, output, woffset3, winput3);
+	for (size_t i = 0; i < interior && trailing < 16; ++i)
+		mask |= 1 << (r >> (8 + 8 * i) & 0xff) % (16 - trailing);
 
-	return kept;
+	return mask;
 }
 
+int differential() {
+	uint8_t src[64];
+	uint8_t ref[64];
+	uint8_t out[64 + 64];
+	uint64_t state = 0x2545f4914f6cdd1d;
+	int ret = 0;
+
+	for (size_t t = 0; t < sizeof(bench_testees) / sizeof(bench_testees[0]); ++t) {
+		bench_testee const& testee = bench_testees[t];
+
+		if (!prune_supported(testee.isa))
+			continue;
+
+		size_t mismatches = 0;
+		size_t mismatches_in_domain = 0;
+		size_t const lanes = testee.batch / 16;
+
+		for (size_t lane = 0; lane < lanes; ++lane)
+			for (uint32_t mask = 0; mask < 0x10000; ++mask) {
+				bool in_domain = true;
+
+				for (size_t l = 0; l < lanes; ++l) {
+					uint32_t const m = l == lane ? mask : random_mask(state, testee.interior_blanks);
+					in_domain = in_domain && interior_blanks(m) <= testee.interior_blanks;
+
+					for (size_t i = 0; i < 16; ++i) {
+						uint64_t const r = random_next(state);
+						src[l * 16 + i] = m >> i & 1 ? r % (' ' + 1) : ' ' + 1 + r % (0xff - ' ');
+					}
+				}
+
+				size_t ref_len = 0;
+				if (testee.reference != NULL)
+					ref_len = testee.reference(src, ref);
+				else
+					for (size_t l = 0; l < lanes; ++l)
+						ref_len += testee00(src + l * 16, ref + ref_len);
+
+				size_t const len = testee.testee(src, out);
+
+				if (len != ref_len || memcmp(out, ref, ref_len) != 0) {
+					++mismatches;
+					if (in_domain)
+						++mismatches_in_domain;
+				}
+			}
+
+		size_t const runs = lanes << 16;
+
+		if (testee.interior_blanks >= 16)
+			fprintf(stdout, "%s: %s -- %zu of %zu masks differ from testee00\n", testee.name,
+				mismatches == 0 ? "exact" : "FAILED", mismatches, runs);
+		else
+			fprintf(stdout, "%s: %s -- conditional, %zu of %zu masks differ from testee00, %zu of them with up to %zu "
+				"blanks ahead of the trailing blanks of every 16 chars\n", testee.name,
+				mismatches_in_domain == 0 ? "ok" : "FAILED", mismatches, runs, mismatches_in_domain,
+				testee.interior_blanks);
+
+		if (testee.interior_blanks >= 16 ? mismatches != 0 : mismatches_in_domain != 0)
+			ret = 1;
+	}
+	return ret;
+}
+
+// Fuzzing of the buffer drivers behind prune_bounded(), prune_positions(), prune_adaptive(), prune_utf8() and
+// prune_stream(): random corpora, lengths, alignments and capacities, against the scalar references; nothing may land
+// past the capacity.
+int fuzz(
+	size_t const iterations) {
+
+	size_t const max_len = 4096;
+	uint8_t* const src = static_cast< uint8_t* >(aligned_alloc(64, 64 + max_len));
+	uint8_t* const dst = static_cast< uint8_t* >(aligned_alloc(64, 64 + max_len + 64));
+	uint8_t* const ref = static_cast< uint8_t* >(malloc(max_len));
+	uint32_t* const positions = static_cast< uint32_t* >(malloc(max_len * sizeof(uint32_t)));
+	uint64_t state = 0x9e3779b97f4a7c15;
+	int ret = 0;
+
+	if (src == NULL || dst == NULL || ref == NULL || positions == NULL) {
+		fprintf(stderr, "error: cannot allocate fuzzing buffers\n");
+		return 1;
+	}
+
+	static corpus_kind const text_kinds[] = { corpus_source, corpus_logs, corpus_prose, corpus_json };
+
+	for (size_t k = 0; k < kernel_count; ++k) {
+		prune_kernel const kernel = prune_kernel(k);
+
+		if (!prune_supported(kernel))
+			continue;
+
+		size_t failures = 0;
+
+		for (size_t n = 0; n < iterations; ++n) {
+			uint64_t const r = random_next(state);
+			size_t const len = random_next(state) % (size_t(1) << (1 + r % 12));
+			size_t const src_offset = r >> 8 & 63;
+			size_t const dst_offset = r >> 16 & 63;
+
+			// synthetic corpora of any density and run length, or now and then text
+			corpus_profile profile = { corpus_blanks, (r >> 32 & 0xff) / 255., double(1 + (r >> 40 & 7)), "" };
+			if ((r >> 24 & 3) == 0)
+				profile.kind = text_kinds[r >> 26 & 3];
+
+			corpus_fill(src + src_offset, len, profile, random_next(state));
+
+			// a sprinkle of control chars and high chars
+			for (size_t i = 0; i < len; ++i) {
+				uint64_t const c = random_next(state);
+				if (c % 16 == 0)
+					src[src_offset + i] = c >> 8;
+			}
+
+			size_t const ref_len = reference(src + src_offset, len, ref);
+
+			// the capacity is either the length, or just enough for the non-blanks
+			size_t const cap = r >> 48 & 1 ? ref_len : len;
+
+			memset(dst, 0xa5, 64 + max_len + 64);
+			size_t const dst_len = prune_bounded(src + src_offset, len, dst + dst_offset, cap, kernel);
+
+			bool ok = dst_len == ref_len && memcmp(dst + dst_offset, ref, ref_len) == 0;
+			for (size_t i = dst_offset + cap; i < 64 + max_len + 64; ++i)
+				ok = ok && dst[i] == 0xa5;
+
+			if (!ok && failures++ == 0)
+				fprintf(stderr, "%s: fuzz iteration %zu mismatch, length %zu, capacity %zu\n",
+					prune_kernel_name(kernel), n, len, cap);
+
+			// the position version, whose offsets must point back at the non-blanks, in order
+			memset(dst, 0xa5, 64 + max_len + 64);
+			size_t const positions_len = prune_positions(src + src_offset, len, dst + dst_offset, positions, kernel);
+
+			ok = positions_len == ref_len && memcmp(dst + dst_offset, ref, ref_len) == 0;
+			for (size_t i = dst_offset + len; i < 64 + max_len + 64; ++i)
+				ok = ok && dst[i] == 0xa5;
+
+			for (size_t i = 0, kept = 0; ok && i < len; ++i)
+				if (src[src_offset + i] > ' ')
+					ok = positions[kept++] == i;
+
+			if (!ok && failures++ == 0)
+				fprintf(stderr, "%s: fuzz iteration %zu positions mismatch, length %zu\n",
+					prune_kernel_name(kernel), n, len);
+
+			// the adaptive version, whose counters must account for every block
+			prune_paths paths = { 0, 0, 0, 0, 0 };
+
+			memset(dst, 0xa5, 64 + max_len + 64);
+			size_t const adaptive_len = prune_adaptive(src + src_offset, len, dst + dst_offset, paths, kernel);
+
+			ok = adaptive_len == ref_len && memcmp(dst + dst_offset, ref, ref_len) == 0;
+			for (size_t i = dst_offset + len; i < 64 + max_len + 64; ++i)
+				ok = ok && dst[i] == 0xa5;
+
+#if __aarch64__
+			size_t const batch = 32;
+#else
+			size_t const batch = kernel == kernel_testee10 ? 64 : kernel == kernel_testee09 ? 32 : 16;
 #endif
-#elif __SSSE3__ && __POPCNT__
-// pruner proper, 16-batch; amd64 cannot properly recreate arm64's testee04, so get creative
-inline size_t testee04() {
-	__m128i const vin = _mm_load_si128(reinterpret_cast< __m128i const* >(input));
-	__m128i const bmask = _mm_cmplt_epi8(vin, _mm_set1_epi8(' ' + 1));
-
-	// OR the mask of all blanks with the original index of the vector
-	__m128i const risen = _mm_or_si128(bmask, _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
-
-	// now just sort that 'risen' to get the desired index of all non-blanks in the front, and all blanks in the back;
-	// an observation: we don't need to sort the entire risen index as a whole, we can sort it piece-wise
-
-	// 4-element sorting network: http://pages.ripco.net/~jgamble/nw.html -- 'Best version', 4 clusters of
-	//
-	//  [[0,1],[2,3]]  [[4,5],[6,7]]  [[8,9],[a,b]]  [[c,d],[e,f]]
-	//  [[0,2],[1,3]]  [[4,6],[5,7]]  [[8,a],[9,b]]  [[c,e],[d,f]]
-	//  [[1,2]]        [[5,6]]        [[9,a]]        [[d,e]]
-	//
-
-	__m128i const st0a = _mm_shuffle_epi8(risen, _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st0b = _mm_shuffle_epi8(risen, _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st0min = _mm_min_epu8(st0a, st0b); // 0, 2, 4, 6, 8, a, c, e
-	__m128i const st0max = _mm_max_epu8(st0a, st0b); // 1, 3, 5, 7, 9, b, d, f
-
-	__m128i const st0 = _mm_unpacklo_epi64(st0min, st0max);
-	__m128i const st1a = _mm_shuffle_epi8(st0, _mm_setr_epi8(0, 8, 2, 10, 4, 12, 6, 14, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st1b = _mm_shuffle_epi8(st0, _mm_setr_epi8(1, 9, 3, 11, 5, 13, 7, 15, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st1min = _mm_min_epu8(st1a, st1b); // 0, 1, 4, 5, 8, 9, c, d
-	__m128i const st1max = _mm_max_epu8(st1a, st1b); // 2, 3, 6, 7, a, b, e, f
-
-	__m128i const st2a =                  st1min;
-	__m128i const st2b = _mm_shuffle_epi8(st1max, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st2min = _mm_min_epu8(st2a, st2b); // [0], 1, [4], 5, [8], 9, [c], d
-	__m128i const st2max = _mm_max_epu8(st2a, st2b); // [3], 2, [7], 6, [b], a, [f], e
-
-	__m128i const st2 = _mm_unpacklo_epi64(st2min, st2max);
-	__m128i const index = _mm_shuffle_epi8(st2, _mm_setr_epi8(0, 1, 9, 8, 2, 3, 11, 10, 4, 5, 13, 12, 6, 7, 15, 14));
-
-	__m128i const res0 = _mm_shuffle_epi8(vin, index);
-	__m128i const res1 = _mm_shuffle_epi32(res0, 0x55);
-	__m128i const res2 = _mm_shuffle_epi32(res0, 0xee);
-	__m128i const res3 = _mm_shuffle_epi32(res0, 0xff);
-
-	uint32_t const bitmask = ~_mm_movemask_epi8(bmask);
-	uint32_t const len0 = _mm_popcnt_u32(bitmask & 0x00f);
-	uint32_t const len1 = _mm_popcnt_u32(bitmask & 0x0ff);
-	uint32_t const len2 = _mm_popcnt_u32(bitmask & 0xfff);
-
-	*reinterpret_cast< uint32_t* >(output)        = _mm_cvtsi128_si32(res0);
-	*reinterpret_cast< uint32_t* >(output + len0) = _mm_cvtsi128_si32(res1);
-	*reinterpret_cast< uint32_t* >(output + len1) = _mm_cvtsi128_si32(res2);
-	*reinterpret_cast< uint32_t* >(output + len2) = _mm_cvtsi128_si32(res3);
-	return _mm_popcnt_u32(bitmask & 0xffff);
-}
-
-// pruner proper, 16-batch
-inline size_t testee05() {
-	__m128i const vin = _mm_load_si128(reinterpret_cast< __m128i const* >(input));
-	__m128i const bmask = _mm_cmplt_epi8(vin, _mm_set1_epi8(' ' + 1));
-
-	// OR the mask of all blanks with the original index of the vector
-	__m128i const risen = _mm_or_si128(bmask, _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
-
-	// now just sort that 'risen' to get the desired index of all non-blanks in the front, and all blanks in the back
-
-	// 16-element sorting network: http://pages.ripco.net/~jgamble/nw.html -- 'Best version'
-	// stage 0
-	__m128i const st0a = _mm_shuffle_epi8(risen, _mm_setr_epi8( 0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st0b = _mm_shuffle_epi8(risen, _mm_setr_epi8( 1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st0min = _mm_min_epu8(st0a, st0b); //  0, 2, 4, 6, 8, 10, 12, 14
-	__m128i const st0max = _mm_max_epu8(st0a, st0b); //  1, 3, 5, 7, 9, 11, 13, 15
-
-	// stage 1
-	__m128i const st0 = _mm_unpacklo_epi64(st0min, st0max);
-	__m128i const st1a = _mm_shuffle_epi8(st0, _mm_setr_epi8( 0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st1b = _mm_shuffle_epi8(st0, _mm_setr_epi8( 1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st1min = _mm_min_epu8(st1a, st1b); //  0, 4,  8, 12, 1, 5,  9, 13
-	__m128i const st1max = _mm_max_epu8(st1a, st1b); //  2, 6, 10, 14, 3, 7, 11, 15
-
-	// stage 2
-	__m128i const st1 = _mm_unpacklo_epi64(st1min, st1max);
-	__m128i const st2a = _mm_shuffle_epi8(st1, _mm_setr_epi8( 0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st2b = _mm_shuffle_epi8(st1, _mm_setr_epi8( 1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st2min = _mm_min_epu8(st2a, st2b); //  0,  8, 1,  9, 2, 10, 3, 11
-	__m128i const st2max = _mm_max_epu8(st2a, st2b); //  4, 12, 5, 13, 6, 14, 7, 15
-
-	// stage 3
-	__m128i const st2 = _mm_unpacklo_epi64(st2min, st2max);
-	__m128i const st3a = _mm_shuffle_epi8(st2, _mm_setr_epi8( 0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st3b = _mm_shuffle_epi8(st2, _mm_setr_epi8( 1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st3min = _mm_min_epu8(st3a, st3b); // 0, 1,  2,  3,  4,  5,  6,  7
-	__m128i const st3max = _mm_max_epu8(st3a, st3b); // 8, 9, 10, 11, 12, 13, 14, 15
-
-	// from here on some indices are already done -- freeze them, by keeping them in deterministic positions
-
-	// stage 4; indices done so far: 0, 15
-	__m128i const st3 = _mm_unpacklo_epi64(st3min, st3max);
-	__m128i const st4a = _mm_shuffle_epi8(st3, _mm_setr_epi8( 0,  5, 6,  3, 13,  7, 1, 4, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st4b = _mm_shuffle_epi8(st3, _mm_setr_epi8(15, 10, 9, 12, 14, 11, 2, 8, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st4min = _mm_min_epu8(st4a, st4b); // [ 0],  5,  6,  3, 13,  7,  1,  4
-	__m128i const st4max = _mm_max_epu8(st4a, st4b); // [15], 10,  9, 12, 14, 11,  2,  8
-
-	// stage 5; done so far: 0, 15; temp frozen: 3, 12
-	__m128i const st4 = _mm_unpacklo_epi64(st4min, st4max);
-	__m128i const st5a = _mm_shuffle_epi8(st4, _mm_setr_epi8( 0,  3, 6, 5, 14, 13, 1, 10, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st5b = _mm_shuffle_epi8(st4, _mm_setr_epi8( 8, 11, 7, 4, 15, 12, 2,  9, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st5min = _mm_min_epu8(st5a, st5b); // [ 0], [ 3], 1,  7,  2, 11, 5,  9
-	__m128i const st5max = _mm_max_epu8(st5a, st5b); // [15], [12], 4, 13,  8, 14, 6, 10
-
-	// stage 6; done so far: 0, 1, 14, 15; temp frozen: 5, 6, 9, 10
-	__m128i const st5 = _mm_unpacklo_epi64(st5min, st5max);
-	__m128i const st6a = _mm_shuffle_epi8(st5, _mm_setr_epi8( 0,  2,  4,  5,  1, 3,  6,  7, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st6b = _mm_shuffle_epi8(st5, _mm_setr_epi8( 8, 13, 10, 11, 12, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st6min = _mm_min_epu8(st6a, st6b); // [ 0], [ 1], 2, 11,  3,  7, [5], [ 9]
-	__m128i const st6max = _mm_max_epu8(st6a, st6b); // [15], [14], 4, 13,  8, 12, [6], [10]
-
-	// stage 7; done so far: 0, 1, 2, 13, 14, 15; temp frozen: 4, 11
-	__m128i const st6 = _mm_unpacklo_epi64(st6min, st6max);
-	__m128i const st7a = _mm_shuffle_epi8(st6, _mm_setr_epi8( 0, 1,  2,  3, 14, 15, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st7b = _mm_shuffle_epi8(st6, _mm_setr_epi8( 8, 9, 10, 11, 12, 13, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st7min = _mm_min_epu8(st7a, st7b); // [ 0], [ 1], [2], [11],  6, 10, 3, 7
-	__m128i const st7max = _mm_max_epu8(st7a, st7b); // [15], [14], [4], [13],  8, 12, 5, 9
-
-	// stage 8; done so far: 0, 1, 2, 13, 14, 15
-	__m128i const st7 = _mm_unpacklo_epi64(st7min, st7max);
-	__m128i const st8a = _mm_shuffle_epi8(st7, _mm_setr_epi8( 0, 1,  2,  6, 14,  7, 15,  3, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st8b = _mm_shuffle_epi8(st7, _mm_setr_epi8( 8, 9, 11, 10,  4, 12,  5, 13, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st8min = _mm_min_epu8(st8a, st8b); // [ 0], [ 1], [ 2],  3,  5,  7,  9, 11
-	__m128i const st8max = _mm_max_epu8(st8a, st8b); // [15], [14], [13],  4,  6,  8, 10, 12
-
-	// stage 9; done so far: 0, 1, 2, 3, 4, 5, 10, 11, 12, 13, 14, 15
-	__m128i const st8 = _mm_unpacklo_epi64(st8min, st8max);
-	__m128i const st9a = _mm_shuffle_epi8(st8, _mm_setr_epi8( 0, 1,  2,  3, 11,  4, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st9b = _mm_shuffle_epi8(st8, _mm_setr_epi8( 8, 9, 10, 15,  7, 14,  5,  6, -1, -1, -1, -1, -1, -1, -1, -1));
-	__m128i const st9min = _mm_min_epu8(st9a, st9b); // [ 0], [ 1], [ 2], [ 3], [ 4], [ 5],  6,  8
-	__m128i const st9max = _mm_max_epu8(st9a, st9b); // [15], [14], [13], [12], [11], [10],  7,  9
-
-	__m128i const st9 = _mm_unpacklo_epi64(st9min, st9max);
-	__m128i const index = _mm_shuffle_epi8(st9, _mm_setr_epi8( 0, 1, 2, 3, 4, 5, 6, 14, 7, 15, 13, 12, 11, 10, 9, 8 ));
-
-	__m128i const res = _mm_shuffle_epi8(vin, index);
-	_mm_storeu_si128(reinterpret_cast< __m128i* >(output), res);
-	return sizeof(__m128i) - _mm_popcnt_u32(_mm_movemask_epi8(bmask));
+			size_t const counted = 64 * (paths.clean_blocks + paths.blank_blocks) +
+				batch * (paths.clean_batches + paths.blank_batches + paths.mixed_batches);
+			bool const scalar = kernel == kernel_testee00 || kernel == kernel_testee16 || kernel == kernel_testee17;
+			ok = ok && counted == (scalar ? 0 : (len + 63) / 64 * 64);
+
+			if (!ok && failures++ == 0)
+				fprintf(stderr, "%s: fuzz iteration %zu adaptive mismatch, length %zu\n",
+					prune_kernel_name(kernel), n, len);
+
+			// the UTF-8 version, over the same chars -- ill-formed UTF-8 wherever the high chars went
+			bool ref_valid, valid;
+			size_t const utf8_ref_len = reference_utf8(src + src_offset, len, ref, ref_valid);
+
+			memset(dst, 0xa5, 64 + max_len + 64);
+			size_t const utf8_len = prune_utf8(src + src_offset, len, dst + dst_offset, valid, kernel);
+
+			ok = utf8_len == utf8_ref_len && memcmp(dst + dst_offset, ref, utf8_ref_len) == 0 && valid == ref_valid;
+			for (size_t i = dst_offset + len; i < 64 + max_len + 64; ++i)
+				ok = ok && dst[i] == 0xa5;
+
+			if (!ok && failures++ == 0)
+				fprintf(stderr, "%s: fuzz iteration %zu UTF-8 mismatch, length %zu\n",
+					prune_kernel_name(kernel), n, len);
+
+			// the streaming version, at any prefetch distance, which writes nothing but the non-blanks
+			memset(dst, 0xa5, 64 + max_len + 64);
+			size_t const stream_len = prune_stream(src + src_offset, len, dst + dst_offset, kernel, r >> 52);
+
+			ok = stream_len == ref_len && memcmp(dst + dst_offset, ref, ref_len) == 0;
+			for (size_t i = 0; i < 64 + max_len + 64; ++i)
+				ok = ok && (dst[i] == 0xa5 || (i >= dst_offset && i < dst_offset + ref_len));
+
+			if (!ok && failures++ == 0)
+				fprintf(stderr, "%s: fuzz iteration %zu stream mismatch, length %zu\n",
+					prune_kernel_name(kernel), n, len);
+		}
+
+		fprintf(stdout, "%s: %s -- %zu of %zu fuzzed buffers differ from the reference\n", prune_kernel_name(kernel),
+			failures == 0 ? "ok" : "FAILED", failures, iterations);
+		if (failures != 0)
+			ret = 1;
+	}
+
+	free(positions);
+	free(ref);
+	free(dst);
+	free(src);
+	return ret;
+}
+
+// PMU counters of this thread in user mode, cycles leading a group with instructions; -1 when not available
+int pmu_cycles = -1;
+int pmu_instructions = -1;
+
+#if __linux__
+int pmu_open(
+	uint64_t const config,
+	int const group) {
+
+	perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(attr);
+	attr.config = config;
+	attr.disabled = group == -1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP;
+
+	return syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
 }
 
 #endif
-int main(int, char**) {
-	size_t const rep = size_t(5e7);
+bool pmu_init() {
+
+#if __linux__
+	pmu_cycles = pmu_open(PERF_COUNT_HW_CPU_CYCLES, -1);
+	if (pmu_cycles == -1)
+		return false;
+
+	pmu_instructions = pmu_open(PERF_COUNT_HW_INSTRUCTIONS, pmu_cycles);
+	if (pmu_instructions == -1) {
+		close(pmu_cycles);
+		pmu_cycles = -1;
+		return false;
+	}
+	return true;
+
+#else
+	return false;
+
+#endif
+}
 
-	for (size_t i = 0; i < rep; ++i) {
+void pmu_start() {
 
-#if TESTEE == 8 && defined(__ARM_FEATURE_SVE)
-		testee08();
+#if __linux__
+	if (pmu_cycles == -1)
+		return;
 
-#elif TESTEE == 7
-		testee07();
+	ioctl(pmu_cycles, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(pmu_cycles, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
 
-#elif TESTEE == 6
-		testee06();
+#endif
+}
 
-#elif TESTEE == 5
-		testee05();
+// stop the counters and fetch their counts; false when not available
+bool pmu_stop(
+	uint64_t& cycles,
+	uint64_t& instructions) {
 
-#elif TESTEE == 4
-		testee04();
+#if __linux__
+	if (pmu_cycles == -1)
+		return false;
 
-#elif TESTEE == 3
-		testee03();
+	ioctl(pmu_cycles, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
 
-#elif TESTEE == 2
-		testee02();
+	uint64_t group[3]; // nr, cycles, instructions
+	if (read(pmu_cycles, group, sizeof(group)) != sizeof(group) || group[0] != 2)
+		return false;
 
-#elif TESTEE == 1
-		testee01();
+	cycles = group[1];
+	instructions = group[2];
+	return true;
 
 #else
-		testee00();
+	return false;
 
 #endif
-		// iteration obfuscator
-		asm volatile ("" : : : "memory");
+}
+
+// nearest-rank percentile of the samples, which get sorted in the process
+double percentile(
+	std::vector< double >& samples,
+	double const p) {
+
+	std::sort(samples.begin(), samples.end());
+	size_t const rank = size_t(ceil(p * samples.size()));
+	return samples[rank > 0 ? rank - 1 : 0];
+}
+
+// the 'model name' of the first CPU per /proc/cpuinfo, for the README tables
+void cpu_model(
+	char* const name,
+	size_t const size) {
+
+	snprintf(name, size, "unknown");
+
+	FILE* const f = fopen("/proc/cpuinfo", "r");
+	if (f == NULL)
+		return;
+
+	char line[256];
+	while (fgets(line, sizeof(line), f) != NULL) {
+		char const* const colon = strchr(line, ':');
+
+		if (strncmp(line, "model name", strlen("model name")) != 0 || colon == NULL)
+			continue;
+
+		snprintf(name, size, "%s", colon + 2);
+		name[strcspn(name, "\n")] = '\0';
+		break;
+	}
+	fclose(f);
+}
+
+// a figure for the markdown table, n/a when not measured
+char const* figure(
+	char* const text,
+	size_t const size,
+	char const* const format,
+	double const value) {
+
+	if (value != value)
+		return "n/a";
+
+	snprintf(text, size, format, value);
+	return text;
+}
+
+#if __clang__
+char const compiler[] = "clang++ " __clang_version__;
+#elif __GNUC__
+char const compiler[] = "g++ " __VERSION__;
+#else
+char const compiler[] = "unknown";
+#endif
+
+void usage(
+	char const* const name) {
+
+	fprintf(stderr, "usage: %s [bench] [-t trials] [-w warmup_trials] [-n batches_per_trial] [-p profile[,..]] "
+		"[-k KiB_per_corpus[:max_KiB]] [-s seed] [-e KiB_evicted_per_pass] [-f prefetch_chars] [-m] [testee..]\n"
+		"       %s verify\n"
+		"       %s scaling [MiB]\n"
+		"       %s corpus [profile [KiB [seed]]]\n"
+		"profiles: input, source, logs, prose, json, utf8, blanks:percent[:run_length], density[:run_length], all\n",
+		name, name, name, name);
+}
+
+// time the testees named on the command line, or all of them, over each of the profiles given with -p, at each of the
+// corpus sizes given with -k; CSV on stdout, or with -m the rows of a markdown table
+int bench(
+	int argc,
+	char** argv) {
+
+	size_t trials = 101;
+	size_t warmup = 5;
+	size_t reps = size_t(1) << 21;
+	size_t min_kib = 16;
+	size_t max_kib = 16;
+	size_t evict_kib = 0;
+	uint64_t seed = 1;
+	bool markdown = false;
+	std::vector< corpus_profile > profiles;
+
+	char const* const name = argv[0];
+
+	if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+		--argc;
+		++argv;
+	}
+
+	int opt;
+	while ((opt = getopt(argc, argv, "t:w:n:p:k:s:e:f:mh")) != -1) {
+		switch (opt) {
+		case 't':
+			trials = strtoul(optarg, NULL, 10);
+			break;
+		case 'w':
+			warmup = strtoul(optarg, NULL, 10);
+			break;
+		case 'n':
+			reps = strtoul(optarg, NULL, 10);
+			break;
+		case 'p':
+			if (!corpus_parse(optarg, profiles)) {
+				fprintf(stderr, "error: bad profile list '%s'\n", optarg);
+				return 2;
+			}
+			break;
+		case 'k': {
+			// a single size, or a range swept in powers of two
+			char* end;
+			min_kib = max_kib = strtoul(optarg, &end, 10);
+			if (*end == ':')
+				max_kib = strtoul(end + 1, &end, 10);
+
+			if (*end != '\0' || min_kib == 0 || max_kib < min_kib) {
+				fprintf(stderr, "error: bad corpus size '%s'\n", optarg);
+				return 2;
+			}
+			break;
+		}
+		case 's':
+			seed = strtoull(optarg, NULL, 0);
+			break;
+		case 'e':
+			evict_kib = strtoul(optarg, NULL, 10);
+			break;
+		case 'f':
+			bench_prefetch = strtoul(optarg, NULL, 10);
+			break;
+		case 'm':
+			markdown = true;
+			break;
+		default:
+			usage(name);
+			return opt == 'h' ? 0 : 2;
+		}
+	}
+
+	// a name that matches no testee -- a typo, or a mode that does not exist -- would otherwise time nothing, quietly
+	for (int i = optind; i < argc; ++i) {
+		bool known = false;
+		for (size_t t = 0; t < sizeof(bench_testees) / sizeof(bench_testees[0]); ++t)
+			known = known || strcmp(argv[i], bench_testees[t].name) == 0;
+
+		if (!known) {
+			fprintf(stderr, "error: unknown testee '%s'\n", argv[i]);
+			usage(name);
+			return 2;
+		}
+	}
+
+	if (trials == 0 || reps == 0) {
+		fprintf(stderr, "error: trials and batches per trial must be non-zero\n");
+		return 2;
+	}
+
+	// the input profile is all of a single batch; a sweep of sizes, or of passes over a cold cache, wants something bigger
+	if (profiles.empty())
+		corpus_parse(min_kib == max_kib && evict_kib == 0 ? "input" : "prose", profiles);
+
+	size_t const max_len = max_kib << 10;
+	uint8_t* const src = static_cast< uint8_t* >(aligned_alloc(64, max_len));
+	uint8_t* const dst = static_cast< uint8_t* >(aligned_alloc(64, max_len + 64));
+
+	// polluter, walked ahead of each pass over the corpus when asked to -- a stand-in for whatever else the core runs
+	// between the buffers it prunes, that leaves the tables of the testees cold
+	size_t const evict_len = evict_kib << 10;
+	uint8_t* const evict = static_cast< uint8_t* >(aligned_alloc(64, evict_len + 64));
+
+	if (src == NULL || dst == NULL || evict == NULL) {
+		fprintf(stderr, "error: cannot allocate %zu KiB\n", max_kib * 2 + evict_kib);
+		return 1;
+	}
+
+	// fault the output and the polluter in ahead of the timings
+	memset(dst, 0, max_len + 64);
+	memset(evict, 0, evict_len + 64);
+
+	bool const pmu = pmu_init();
+	if (!pmu)
+		fprintf(stderr, "warning: PMU counters not available (perf_event_paranoid?); no clocks/char or IPC\n");
+
+	char cpu[128];
+	cpu_model(cpu, sizeof(cpu));
+
+	if (markdown)
+		fprintf(stdout,
+			"| CPU | compiler | testee | clocks/char, median | clocks/char, p99 | IPC | ns/char |\n"
+			"|-----|----------|--------|---------------------|------------------|-----|---------|\n");
+	else
+		fprintf(stdout, "testee,profile,blank_fraction,corpus_bytes,batch,trials,chars_per_trial,clocks_per_char_median,"
+			"clocks_per_char_p99,ipc_median,ns_per_char_median,ns_per_char_p99,gb_per_s_median,evict_bytes\n");
+
+	for (size_t p = 0; p < profiles.size(); ++p) {
+		corpus_profile const& profile = profiles[p];
+
+		// the generator takes its time, and past a few MiB a repeat is as good as new to the caches
+		if (profile.kind != corpus_input) {
+			size_t const generated = max_len < (size_t(16) << 20) ? max_len : size_t(16) << 20;
+			corpus_fill(src, generated, profile, seed);
+
+			for (size_t i = generated; i < max_len; i += generated)
+				memcpy(src + i, src, max_len - i < generated ? max_len - i : generated);
+		}
+
+		for (size_t kib = min_kib; kib <= max_kib; kib *= 2) {
+			size_t const corpus_len = kib << 10;
+
+			// the input profile knows no sizes
+			if (profile.kind == corpus_input && kib != min_kib)
+				break;
+
+			for (size_t t = 0; t < sizeof(bench_testees) / sizeof(bench_testees[0]); ++t) {
+				bench_testee const& testee = bench_testees[t];
+
+				if (!prune_supported(testee.isa))
+					continue;
+
+				if (optind < argc) {
+					bool named = false;
+					for (int i = optind; i < argc; ++i)
+						named = named || strcmp(argv[i], testee.name) == 0;
+
+					if (!named)
+						continue;
+				}
+
+				// the input profile is the single batch of the perf sessions, over and over; a corpus gets pruned
+				// batch by batch, as many times over as make about the same count of batches per trial
+				uint8_t const* const in = profile.kind == corpus_input ? input : src;
+				uint8_t* const out = profile.kind == corpus_input ? output : dst;
+				size_t const len = profile.kind == corpus_input ? testee.batch : corpus_len / testee.batch * testee.batch;
+				size_t const passes = profile.kind == corpus_input ? reps : (reps * testee.batch + len - 1) / len;
+				size_t const evicted = profile.kind == corpus_input ? 0 : evict_len;
+
+				size_t blanks = 0;
+				for (size_t i = 0; i < len; ++i)
+					blanks += in[i] <= ' ';
+
+				bench_input = in;
+				bench_output = out;
+
+				for (size_t trial = 0; trial < warmup; ++trial)
+					testee.run(in, len, out, passes);
+
+				size_t const chars = passes * len;
+				std::vector< double > clocks, ipc, ns;
+
+				for (size_t trial = 0; trial < trials; ++trial) {
+					double elapsed = 0;
+					uint64_t cycles = 0, instructions = 0;
+					bool counted = true;
+
+					// all passes in one go, or pass by pass with the polluter walked untimed ahead of each
+					for (size_t pass = 0; pass < passes; pass += evicted ? 1 : passes) {
+						timespec t0, t1;
+						uint64_t pass_cycles, pass_instructions;
+
+						for (size_t i = 0; i < evicted; i += 64)
+							evict[i] += 1;
+
+						clock_gettime(CLOCK_MONOTONIC, &t0);
+						pmu_start();
+						testee.run(in, len, out, evicted ? 1 : passes);
+						counted = pmu_stop(pass_cycles, pass_instructions) && counted;
+						clock_gettime(CLOCK_MONOTONIC, &t1);
+
+						elapsed += (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+						cycles += counted ? pass_cycles : 0;
+						instructions += counted ? pass_instructions : 0;
+					}
+
+					ns.push_back(elapsed / chars);
+					if (counted && cycles != 0) {
+						clocks.push_back(double(cycles) / chars);
+						ipc.push_back(double(instructions) / cycles);
+					}
+				}
+
+				double const nan = __builtin_nan("");
+				double const clocks_median = clocks.empty() ? nan : percentile(clocks, .5);
+				double const clocks_p99 = clocks.empty() ? nan : percentile(clocks, .99);
+				double const ipc_median = ipc.empty() ? nan : percentile(ipc, .5);
+				double const ns_median = percentile(ns, .5);
+				double const ns_p99 = percentile(ns, .99);
+
+				if (markdown) {
+					char name[64];
+					char text[3][32];
+
+					if (profile.kind == corpus_input)
+						snprintf(name, sizeof(name), "%s", testee.name);
+					else
+						snprintf(name, sizeof(name), "%s, %s", testee.name, profile.name);
+
+					fprintf(stdout, "| %s | %s | %s | %s | %s | %s | %.4f |\n", cpu, compiler, name,
+						figure(text[0], sizeof(text[0]), "%.4f", clocks_median),
+						figure(text[1], sizeof(text[1]), "%.4f", clocks_p99),
+						figure(text[2], sizeof(text[2]), "%.2f", ipc_median), ns_median);
+				}
+				else
+					fprintf(stdout, "%s,%s,%.3f,%zu,%zu,%zu,%zu,%.4f,%.4f,%.3f,%.5f,%.5f,%.3f,%zu\n",
+						testee.name, profile.name, double(blanks) / len, len, testee.batch, trials, chars,
+						clocks_median, clocks_p99, ipc_median, ns_median, ns_p99, 1 / ns_median, evicted);
+
+				fflush(stdout);
+			}
+		}
 	}
 
 	fprintf(stderr, "%.32s\n", output);
+	free(evict);
+	free(dst);
+	free(src);
 	return 0;
 }
 
+int main(int argc, char** argv) {
+	if (argc > 1 && strcmp(argv[1], "scaling") == 0)
+		return scaling(argc > 2 ? strtoul(argv[2], NULL, 10) : 1024);
+
+	if (argc > 1 && strcmp(argv[1], "verify") == 0) {
+		int const ret = verify();
+		return differential() | fuzz(20000) | ret;
+	}
+
+	if (argc > 1 && strcmp(argv[1], "corpus") == 0)
+		return corpus(argc > 2 ? argv[2] : "prose", argc > 3 ? strtoul(argv[3], NULL, 10) : 16,
+			argc > 4 ? strtoull(argv[4], NULL, 0) : 1);
+
+	return bench(argc, argv);
+}